@@ -3,4 +3,4 @@
 if [ ! -d cadical ]; then
     git clone https://github.com/arminbiere/cadical.git
 fi
-make
+make "$@"
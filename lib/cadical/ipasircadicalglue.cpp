@@ -0,0 +1,75 @@
+/*
+ * IPASIR glue for CaDiCaL including the non-standard functions
+ * (seed, phases, frozen variables) used by Lilotane.
+ * Replaces the ipasir.o of the original CaDiCaL library.
+ */
+
+#include <vector>
+
+#include "cadical.hpp"
+
+extern "C" {
+    #include "ipasir.h"
+}
+
+struct IPAsirCadical : public CaDiCaL::Terminator, public CaDiCaL::Learner {
+
+    CaDiCaL::Solver solver;
+
+    void* terminateState = nullptr;
+    int (*terminateCallback)(void*) = nullptr;
+
+    void* learnState = nullptr;
+    int learnMaxLength = 0;
+    void (*learnCallback)(void*, int*) = nullptr;
+    std::vector<int> learntClause;
+
+    bool terminate() override {
+        return terminateCallback != nullptr && terminateCallback(terminateState);
+    }
+
+    bool learning(int size) override {
+        return learnCallback != nullptr && size <= learnMaxLength;
+    }
+    void learn(int lit) override {
+        learntClause.push_back(lit);
+        if (lit == 0) {
+            learnCallback(learnState, learntClause.data());
+            learntClause.clear();
+        }
+    }
+};
+
+static IPAsirCadical* import(void* s) {return (IPAsirCadical*) s;}
+
+const char* ipasir_signature() {return CaDiCaL::Solver::signature();}
+void* ipasir_init() {return new IPAsirCadical();}
+void ipasir_release(void* s) {delete import(s);}
+void ipasir_add(void* s, int lit) {import(s)->solver.add(lit);}
+void ipasir_assume(void* s, int lit) {import(s)->solver.assume(lit);}
+int ipasir_solve(void* s) {return import(s)->solver.solve();}
+int ipasir_val(void* s, int lit) {return import(s)->solver.val(lit);}
+int ipasir_failed(void* s, int lit) {return import(s)->solver.failed(lit) ? 1 : 0;}
+
+void ipasir_set_terminate(void* s, void* state, int (*terminate)(void* state)) {
+    import(s)->terminateState = state;
+    import(s)->terminateCallback = terminate;
+    if (terminate) import(s)->solver.connect_terminator(import(s));
+    else import(s)->solver.disconnect_terminator();
+}
+
+void ipasir_set_learn(void* s, void* state, int max_length, void (*learn)(void* state, int* clause)) {
+    import(s)->learnState = state;
+    import(s)->learnMaxLength = max_length;
+    import(s)->learnCallback = learn;
+    if (learn) import(s)->solver.connect_learner(import(s));
+    else import(s)->solver.disconnect_learner();
+}
+
+void ipasir_set_seed(void* s, int seed) {import(s)->solver.set("seed", seed);}
+void ipasir_set_phase(void* s, unsigned int v, bool phase) {import(s)->solver.phase(phase ? (int)v : -(int)v);}
+void ipasir_set_decision_var(void* s, unsigned int v, bool decision_var) { /*Not supported by CaDiCaL.*/ }
+void ipasir_set_frozen(void* s, unsigned int v, bool frozen) {
+    if (frozen) import(s)->solver.freeze(v);
+    else if (import(s)->solver.frozen(v)) import(s)->solver.melt(v);
+}
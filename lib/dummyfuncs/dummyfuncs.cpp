@@ -3,5 +3,6 @@ extern "C" {
     #include "ipasir.h"
     void ipasir_set_decision_var (void * s, unsigned int v, bool decision_var) {}
     void ipasir_set_phase (void * s, unsigned int v, bool phase) {}
+    void ipasir_set_frozen (void * s, unsigned int v, bool frozen) {}
     void ipasir_set_seed (void * s, int seed) {} 
 };
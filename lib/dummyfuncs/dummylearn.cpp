@@ -0,0 +1,7 @@
+
+// Kept apart from dummyfuncs.cpp: this object is only linked
+// if the solver library does not provide ipasir_set_learn itself.
+extern "C" {
+    #include "ipasir.h"
+    void ipasir_set_learn (void * s, void * state, int max_length, void (*learn)(void * state, int * clause)) {}
+};
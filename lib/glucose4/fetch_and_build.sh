@@ -7,4 +7,4 @@ if [ ! -d glucose-4 ]; then
     patch glucose-4/core/Solver.h < Solver.h.patch
     patch glucose-4/core/Solver.cc < Solver.cc.patch
 fi
-make
+make "$@"
@@ -6,6 +6,7 @@
  */
 
 
+#include <string>
 
 extern "C" {
     #include "ipasir.h"
@@ -13,7 +14,8 @@ extern "C" {
 }
 
 const char* ipasir_signature() {
-	return lglversion();
+	static std::string signature = std::string("lingeling-") + lglversion();
+	return signature.c_str();
 }
 
 void* ipasir_init() {
@@ -51,11 +53,3 @@ int ipasir_failed(void * solver, int lit) {
 void ipasir_set_terminate(void * solver,  void * state, int (*terminate)(void * state)) {
 	lglseterm((LGL*)solver, terminate, state);
 }
-
-void ipasir_set_learn (void * solver, void * state, int max_length, void (*learn)(void * state, int * clause)) {
-	//not implemented
-}
-
-void ipasir_set_decision_var (void * s, unsigned int v, bool decision_var) { /*Not implemented.*/ }
-void ipasir_set_phase (void * s, unsigned int v, bool phase) { /*Not implemented.*/ }
-void ipasir_set_seed (void * s, int seed) { /*Not implemented.*/ }
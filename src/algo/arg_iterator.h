@@ -84,6 +84,10 @@ public:
         return _end;
     }
 
+    const std::vector<std::vector<int>>& getEligibleArgs() const {
+        return _eligible_args;
+    }
+
     int size() {
         int size = 1;
         for (const auto& args: _eligible_args) {
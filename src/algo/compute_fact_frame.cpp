@@ -29,7 +29,7 @@ void FactAnalysisPreprocessing::computeFactFramesTree() {
 
     _fluent_predicates = findFluentPredicates(orderedOpIds);
 
-    fillRigidPredicateCache();
+    fillRigidPredicateIndex();
 
     fillFactFramesBase(orderedOpIds);
 
@@ -42,16 +42,8 @@ void FactAnalysisPreprocessing::computeFactFramesTree() {
     // }
 }
 
-void FactAnalysisPreprocessing::fillRigidPredicateCache() {
-    for (const auto& fact: _init_state) {
-        if (!_fluent_predicates.count(fact._name_id)) {
-            for (size_t argPosition = 0; argPosition < fact._args.size(); argPosition++) {
-                USignature copy = fact;
-                copy._args[argPosition] = _htn.nameId("??_");
-                _rigid_predicate_cache[fact._name_id][copy].insert(fact._args[argPosition]);
-            }
-        }
-    }
+void FactAnalysisPreprocessing::fillRigidPredicateIndex() {
+    _rigid_predicate_index.build(_init_state, _fluent_predicates);
 }
 
 std::vector<int> FactAnalysisPreprocessing::calcOrderedOpList() {
@@ -386,8 +378,8 @@ void FactAnalysisPreprocessing::fillPFCNodesTopDownBFS(std::vector<int>& ordered
                                             childNode.newArgs.insert(newArgument);
                                         }
                                     }
-                                    s = s.concatenate(Substitution(argsToSubstitute, argSubstitutions));
-                                    s = s.concatenate(Substitution(subtaskReduction.getSignature()._args, child.sig._args));
+                                    s = std::move(s).concatenate(Substitution(argsToSubstitute, argSubstitutions));
+                                    s = std::move(s).concatenate(Substitution(subtaskReduction.getSignature()._args, child.sig._args));
                                     childNode.substitute(s);
                                     childNode.substitution = s;
                                     (*newSubtask)[newChild._name_id] = childNode;
@@ -1,6 +1,7 @@
 #include "data/htn_instance.h"
 #include "algo/network_traversal.h"
 #include "algo/fact_analysis_util.h"
+#include "algo/rigid_predicate_index.h"
 #include "util/params.h"
 
 class FactAnalysisPreprocessing {
@@ -29,7 +30,7 @@ private:
     int _num_custom_vars = 0;
     int MAX_NODES = 100;
     USigSet& _init_state;
-    FlatHashMap<int, FlatHashMap<USignature, FlatHashSet<int>, USignatureHasher>> _rigid_predicate_cache;
+    RigidPredicateIndex _rigid_predicate_index;
     FlatHashSet<int> operationsWithCycleInDescent;
 public:
     FactAnalysisPreprocessing (HtnInstance& htn, NodeHashMap<int, FactFrame>& fact_frames, FactAnalysisUtil& util, Parameters& params, USigSet& init_state) : 
@@ -40,8 +41,8 @@ public:
 
     void computeFactFramesTree();
 
-    FlatHashMap<int, FlatHashMap<USignature, FlatHashSet<int>, USignatureHasher>>& getRigidPredicateCache() {
-        return _rigid_predicate_cache;
+    const RigidPredicateIndex& getRigidPredicateIndex() const {
+        return _rigid_predicate_index;
     }
 
 private:
@@ -70,7 +71,7 @@ private:
     void fillFactFramesAction(int& opId, int& aId, bool& change);
 
     void fillFactFramesBase(std::vector<int>& orderingOplist);
-    void fillRigidPredicateCache();
+    void fillRigidPredicateIndex();
 
     void extendPreconditions(std::vector<int>& orderingOplist);
 
@@ -1,5 +1,6 @@
 
 #include "algo/domination_resolver.h"
+#include "util/timer.h"
 
 DominationResolver::DominationResult DominationResolver::getDominationStatus(const USignature& op, const USignature& other, Position& p) {
     DominationResult res;
@@ -100,8 +101,112 @@ DominationResolver::DominationResult DominationResolver::getDominationStatus(con
     return res;
 }
 
+void DominationResolver::insertCandidate(CandidateIndex& index, const USignature& op) {
+    size_t id = index.ops.size();
+    index.ops.push_back(op);
+    index.alive.push_back(true);
+    index.ids[op] = id;
+    if (index.byConstant.size() < op._args.size()) {
+        index.byConstant.resize(op._args.size());
+        index.byQConstOrigin.resize(op._args.size());
+        index.withConstant.resize(op._args.size());
+        index.withQConst.resize(op._args.size());
+    }
+    for (size_t argIdx = 0; argIdx < op._args.size(); argIdx++) {
+        int arg = op._args[argIdx];
+        if (_htn.isQConstant(arg)) {
+            index.byQConstOrigin[argIdx][_htn.getOriginOfQConstant(arg)].insert(id);
+            index.withQConst[argIdx].insert(id);
+        } else {
+            index.byConstant[argIdx][arg].insert(id);
+            index.withConstant[argIdx].insert(id);
+        }
+    }
+}
+
+void DominationResolver::eraseCandidate(CandidateIndex& index, const USignature& op) {
+    auto it = index.ids.find(op);
+    if (it == index.ids.end()) return;
+    size_t id = it->second;
+    index.ids.erase(it);
+    index.alive[id] = false;
+    for (size_t argIdx = 0; argIdx < op._args.size(); argIdx++) {
+        int arg = op._args[argIdx];
+        if (_htn.isQConstant(arg)) {
+            index.byQConstOrigin[argIdx][_htn.getOriginOfQConstant(arg)].erase(id);
+            index.withQConst[argIdx].erase(id);
+        } else {
+            index.byConstant[argIdx][arg].erase(id);
+            index.withConstant[argIdx].erase(id);
+        }
+    }
+}
+
+void DominationResolver::getCandidates(const CandidateIndex& index, const USignature& op, std::vector<size_t>& candidates) {
+    candidates.clear();
+
+    // Find the argument index with the smallest bucket of compatible ops
+    static const FlatHashSet<size_t> EMPTY;
+    const FlatHashSet<size_t>* best[2] = {nullptr, nullptr};
+    for (size_t argIdx = 0; argIdx < op._args.size() && argIdx < index.byConstant.size(); argIdx++) {
+        int arg = op._args[argIdx];
+        const FlatHashSet<size_t>* buckets[2];
+        if (_htn.isQConstant(arg)) {
+            // Same-origin q-constants or ground constants
+            const auto& byOrigin = index.byQConstOrigin[argIdx];
+            auto it = byOrigin.find(_htn.getOriginOfQConstant(arg));
+            buckets[0] = it == byOrigin.end() ? &EMPTY : &it->second;
+            buckets[1] = &index.withConstant[argIdx];
+        } else {
+            // Same ground constant or q-constants
+            const auto& byConstant = index.byConstant[argIdx];
+            auto it = byConstant.find(arg);
+            buckets[0] = it == byConstant.end() ? &EMPTY : &it->second;
+            buckets[1] = &index.withQConst[argIdx];
+        }
+        if (best[0] == nullptr || buckets[0]->size() + buckets[1]->size() < best[0]->size() + best[1]->size()) {
+            best[0] = buckets[0];
+            best[1] = buckets[1];
+        }
+    }
+
+    if (best[0] == nullptr) {
+        for (size_t id = 0; id < index.alive.size(); id++) if (index.alive[id]) candidates.push_back(id);
+        return;
+    }
+    for (size_t b = 0; b < 2; b++) for (size_t id : *best[b]) {
+        // Ground constants at q-constant arguments must be within the q-constant's domain
+        const USignature& other = index.ops[id];
+        bool plausible = true;
+        for (size_t argIdx = 0; argIdx < op._args.size(); argIdx++) {
+            int arg = op._args[argIdx];
+            int otherArg = other._args[argIdx];
+            if (arg == otherArg) continue;
+            bool isQ = _htn.isQConstant(arg);
+            bool isOtherQ = _htn.isQConstant(otherArg);
+            if (isQ == isOtherQ) {
+                if (!isQ) plausible = false;
+            } else {
+                int q = isQ ? arg : otherArg;
+                int c = isQ ? otherArg : arg;
+                int cIdx = _htn.getConstantIndex(c);
+                if (cIdx < 0 || !_htn.getDomainBitsetOfQConstant(q).test(cIdx)) plausible = false;
+            }
+            if (!plausible) break;
+        }
+        if (plausible) candidates.push_back(id);
+    }
+    // Compare in order of insertion for deterministic results
+    std::sort(candidates.begin(), candidates.end());
+}
+
 void DominationResolver::eliminateDominatedOperations(Position& newPos) {
 
+    float time = Timer::now();
+    size_t numComparisons = _num_comparisons;
+    size_t numDominatedOps = _num_dominated_ops;
+    size_t numOps = newPos.getActions().size() + newPos.getReductions().size();
+
     // Map of an op name id to (map of a dominating op to a set of dominated ops)
     NodeHashMap<int, NodeHashMap<USignature, USigSubstitutionMap, USignatureHasher>> dominatingActionsByName;
     NodeHashMap<int, NodeHashMap<USignature, USigSubstitutionMap, USignatureHasher>> dominatingReductionsByName;
@@ -111,26 +216,36 @@ void DominationResolver::eliminateDominatedOperations(Position& newPos) {
     NodeHashMap<int, NodeHashMap<USignature, USigSubstitutionMap, USignatureHasher>>* dMaps[2] = {
         &dominatingActionsByName, &dominatingReductionsByName
     };
+    std::vector<size_t> candidates;
     for (size_t i = 0; i < 2; i++) {
 
+        NodeHashMap<int, CandidateIndex> indices;
+
         for (const auto& op : *ops[i]) {
             auto& dominatingOps = (*dMaps[i])[op._name_id];
+            auto& index = indices[op._name_id];
 
-            // Compare operation with each currently dominating op of the same name
+            // Compare operation with each plausible currently dominating op of the same name
             USigSubstitutionMap dominated;
             
             if (dominatingOps.empty()) {
                 dominatingOps[op];
+                insertCandidate(index, op);
                 continue;
             }
 
-            for (auto& [other, dominatedByOther] : dominatingOps) {
+            getCandidates(index, op, candidates);
+            bool isDominated = false;
+            for (size_t id : candidates) {
+                const USignature& other = index.ops[id];
+                _num_comparisons++;
                 auto result = getDominationStatus(op, other, newPos);
                 if (result.status == DOMINATED) {
                     // This op is being dominated; mark for deletion
                     //Log::d("DOM %s << %s\n", TOSTR(op), TOSTR(other));
-                    dominatedByOther[op] = std::move(result.qconstSubstitutions);
+                    dominatingOps[other][op] = std::move(result.qconstSubstitutions);
                     dominated.clear();
+                    isDominated = true;
                     break;
                 }
                 if (result.status == DOMINATING) {
@@ -139,8 +254,12 @@ void DominationResolver::eliminateDominatedOperations(Position& newPos) {
                     dominated[other] = std::move(result.qconstSubstitutions);
                 }
             }
+            if (isDominated) continue;
+
             // Delete all ops transitively dominated by this op
             assert(!dominatingOps.count(op));
+            dominatingOps[op];
+            insertCandidate(index, op);
             for (const auto& [other, s] : dominated) {
                 std::vector<USignature> dominatedVec(1, other);
                 std::vector<Substitution> subVec(1, s);
@@ -160,6 +279,7 @@ void DominationResolver::eliminateDominatedOperations(Position& newPos) {
                             subVec.push_back(cat); 
                         }
                         dominatingOps.erase(dominatedOp);
+                        eraseCandidate(index, dominatedOp);
                     }
                 }
             }
@@ -175,4 +295,10 @@ void DominationResolver::eliminateDominatedOperations(Position& newPos) {
             }
         }
     }
+
+    time = Timer::now() - time;
+    _time += time;
+    Log::v("Domination at (%i,%i): %i/%i ops eliminated, %i comparisons, %.4fs\n", 
+        newPos.getLayerIndex(), newPos.getPositionIndex(), _num_dominated_ops - numDominatedOps, 
+        numOps, _num_comparisons - numComparisons, time);
 }
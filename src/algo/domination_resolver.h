@@ -11,6 +11,24 @@ private:
     HtnInstance& _htn;
 
     size_t _num_dominated_ops = 0;
+    size_t _num_comparisons = 0;
+    float _time = 0;
+
+    // Index over the currently dominating ops of a certain name. An op can only be
+    // in a domination relation with ops which, at each argument index, feature the same
+    // ground constant or a q-constant (of the same origin, if the op's argument is a q-constant).
+    struct CandidateIndex {
+        std::vector<USignature> ops;
+        std::vector<bool> alive;
+        FlatHashMap<USignature, size_t, USignatureHasher> ids;
+        // arg index -> ground constant -> ids of ops with this constant at this index
+        std::vector<FlatHashMap<int, FlatHashSet<size_t>>> byConstant;
+        // arg index -> origin of q-constant -> ids of ops with such a q-constant at this index
+        std::vector<FlatHashMap<IntPair, FlatHashSet<size_t>, IntPairHasher>> byQConstOrigin;
+        // arg index -> ids of ops with some ground constant / some q-constant at this index
+        std::vector<FlatHashSet<size_t>> withConstant;
+        std::vector<FlatHashSet<size_t>> withQConst;
+    };
 
 public:
     DominationResolver(HtnInstance& htn) : _htn(htn) {}
@@ -27,6 +45,17 @@ public:
     size_t getNumDominatedOps() const {
         return _num_dominated_ops;
     }
+    size_t getNumComparisons() const {
+        return _num_comparisons;
+    }
+    float getTime() const {
+        return _time;
+    }
+
+private:
+    void insertCandidate(CandidateIndex& index, const USignature& op);
+    void eraseCandidate(CandidateIndex& index, const USignature& op);
+    void getCandidates(const CandidateIndex& index, const USignature& op, std::vector<size_t>& candidates);
 };
 
 #endif
\ No newline at end of file
@@ -5,6 +5,64 @@
 void FactAnalysis::computeFactFrames() {}
 SigSet FactAnalysis::getPossibleFactChanges(const USignature& sig) {}
 
+static size_t getNumDecodings(const std::vector<std::vector<int>>& eligibleArgs) {
+    if (eligibleArgs.empty()) return 0;
+    size_t num = 1;
+    for (const auto& args : eligibleArgs) num *= args.size();
+    return num;
+}
+
+Bitset FactAnalysis::getReachableDecodings(const USignature& qFact, const std::vector<std::vector<int>>& eligibleArgs, bool negated) {
+    
+    if (!_fact_index.getDecodingIds(qFact._name_id, eligibleArgs, _decoding_ids)) {
+        // Some decoding cannot be indexed: check each decoding individually
+        Bitset mask(getNumDecodings(eligibleArgs));
+        size_t i = 0;
+        for (const USignature& decFact : _htn.decodeObjects(qFact, eligibleArgs)) {
+            if (isReachable(decFact, negated)) mask.set(i);
+            i++;
+        }
+        return mask;
+    }
+
+    Bitset mask(_decoding_ids.size());
+    const size_t numIds = _decoding_ids.size();
+    const size_t* ids = _decoding_ids.data();
+    if (negated) {
+        const Bitset& negFacts = _neg_layer_facts.getBits();
+        const Bitset& initFacts = _init_facts.getBits();
+        for (size_t i = 0; i < numIds; i++) {
+            if (negFacts.test(ids[i]) || !initFacts.test(ids[i])) mask.set(i);
+        }
+    } else {
+        const Bitset& posFacts = _pos_layer_facts.getBits();
+        for (size_t i = 0; i < numIds; i++) {
+            if (posFacts.test(ids[i])) mask.set(i);
+        }
+    }
+    return mask;
+}
+
+Bitset FactAnalysis::getUninitializedDecodings(const USignature& qFact, const std::vector<std::vector<int>>& eligibleArgs) {
+
+    if (!_fact_index.getDecodingIds(qFact._name_id, eligibleArgs, _decoding_ids)) {
+        Bitset mask(getNumDecodings(eligibleArgs));
+        size_t i = 0;
+        for (const USignature& decFact : _htn.decodeObjects(qFact, eligibleArgs)) {
+            if (!isInitialized(decFact)) mask.set(i);
+            i++;
+        }
+        return mask;
+    }
+
+    Bitset mask(_decoding_ids.size());
+    const Bitset& initialized = _initialized_facts.getBits();
+    for (size_t i = 0; i < _decoding_ids.size(); i++) {
+        if (!initialized.test(_decoding_ids[i])) mask.set(i);
+    }
+    return mask;
+}
+
 void FactAnalysis::substituteEffectsAndAdd(const SigSet& effects, Substitution& s, NodeHashMap<int, USigSet>& positiveEffects,
      NodeHashMap<int, USigSet>& negativeEffects, NodeHashMap<int, SigSet>& postconditions, NodeHashMap<int, FlatHashSet<int>>& globalFreeArgRestrictions) {
     SigSet subtitutedEffects;
@@ -39,7 +97,7 @@ void FactAnalysis::substituteEffectsAndAdd(const SigSet& effects, Substitution&
 }
 
 bool FactAnalysis::restrictNewVariables(SigSet& preconditions, SigSet& fluentPreconditions, Substitution& s, NodeHashMap<int, FlatHashSet<int>>& freeArgRestrictions, 
-        FlatHashMap<int, FlatHashMap<USignature, FlatHashSet<int>, USignatureHasher>>& rigid_predicate_cache, FlatHashSet<int> nodeArgs,
+        const RigidPredicateIndex& rigidPredicateIndex, FlatHashSet<int> nodeArgs,
         NodeHashMap<int, USigSet>& foundEffectsPositive, NodeHashMap<int, USigSet>& foundEffectsNegative,
         NodeHashMap<int, SigSet>& postconditions, Substitution& globalSub) {
     //Log::e("restrict var call\n");
@@ -60,27 +118,11 @@ bool FactAnalysis::restrictNewVariables(SigSet& preconditions, SigSet& fluentPre
             ArgIterator iter = ArgIterator::getFullInstantiation(substitutedPrecondition._usig, _htn, freeArgRestrictions, true, argPosition);
             substitutedPrecondition._usig._args[argPosition] = actualArg;
             if (iter.size() > _new_variable_domain_size_limit) continue;
+            // Collect the constants at this position over all matching rigid facts
             bool reachedLimit = false;
-            for (const USignature& groundFact : iter) {
-                //Log::d("Ground fact: %s\n", TOSTR(groundFact));
-                if (rigid_predicate_cache.count(substitutedPrecondition._usig._name_id) 
-                && rigid_predicate_cache[substitutedPrecondition._usig._name_id].count(groundFact)) {
-                    if (rigid_predicate_cache[substitutedPrecondition._usig._name_id][groundFact].size() > _new_variable_domain_size_limit) {
-                        reachedLimit = true;
-                        break;
-                    } else if (newRestrictions.size() == 0) {
-                        newRestrictions = rigid_predicate_cache[substitutedPrecondition._usig._name_id][groundFact];
-                    } else {
-                        for (const auto& constant: rigid_predicate_cache[substitutedPrecondition._usig._name_id][groundFact]) {
-                            newRestrictions.insert(constant);
-                            if (newRestrictions.size() > _new_variable_domain_size_limit) {
-                                reachedLimit = true;
-                                break;
-                            }
-                        }
-                    }
-                    if (reachedLimit) break;
-                }
+            if (!iter.getEligibleArgs().empty()) {
+                reachedLimit = !rigidPredicateIndex.getPossibleConstants(substitutedPrecondition._usig._name_id, argPosition, 
+                    iter.getEligibleArgs(), _new_variable_domain_size_limit, newRestrictions);
             }
             if (reachedLimit) break;
             if (!freeArgRestrictions.count(substitutedPrecondition._usig._args[argPosition])) {
@@ -186,12 +228,12 @@ bool FactAnalysis::checkPreconditionValidityRigid(const SigSet& preconditions, N
         //Log::e("checking rigid precondition: %s\n", TOSTR(substitutedPrecondition));
         if (_htn.isFullyGround(substitutedPrecondition._usig) && !_htn.hasQConstants(substitutedPrecondition._usig)) {
             //Log::d("Found ground precondition without qconstants: %s\n", TOSTR(substitutedPrecondition));
-            preconditionsValid = !substitutedPrecondition._negated != !_init_state.count(substitutedPrecondition._usig);
+            preconditionsValid = !substitutedPrecondition._negated != !_init_facts.contains(substitutedPrecondition._usig);
         } else {
             preconditionsValid = false;
             for (const USignature& groundFact : ArgIterator::getFullInstantiation(substitutedPrecondition._usig, _htn, freeArgRestrictions, true)) {
                 //Log::d("Ground fact: %s\n", TOSTR(groundFact));
-                if (_init_state.count(groundFact) == !substitutedPrecondition._negated) {
+                if (_init_facts.contains(groundFact) == !substitutedPrecondition._negated) {
                     preconditionsValid = true;
                     break;
                 }
@@ -222,7 +264,7 @@ bool FactAnalysis::checkPreconditionValidityFluent(SigSet& preconditions, NodeHa
         substitutedPrecondition.negate();
         if (substitutedPrecondition._negated) {
             if (_htn.isFullyGround(substitutedPrecondition._usig) && !_htn.hasQConstants(substitutedPrecondition._usig)) {
-                preconditionsValid = countNegativeGround(foundEffectsNegative[substitutedPrecondition._usig._name_id], substitutedPrecondition._usig, freeArgRestrictions) || !_init_state.count(substitutedPrecondition._usig);
+                preconditionsValid = countNegativeGround(foundEffectsNegative[substitutedPrecondition._usig._name_id], substitutedPrecondition._usig, freeArgRestrictions) || !_init_facts.contains(substitutedPrecondition._usig);
             } else {
                 if (foundEffectsNegative[substitutedPrecondition._usig._name_id].count(substitutedPrecondition._usig)) {
                     preconditionsValid = true;
@@ -230,7 +272,7 @@ bool FactAnalysis::checkPreconditionValidityFluent(SigSet& preconditions, NodeHa
                 }
                 preconditionsValid = false;
                 for (const USignature& groundFact : ArgIterator::getFullInstantiation(substitutedPrecondition._usig, _htn, freeArgRestrictions, true)) {
-                    if (countNegativeGround(foundEffectsNegative[substitutedPrecondition._usig._name_id], groundFact, freeArgRestrictions) || !_init_state.count(groundFact)) {
+                    if (countNegativeGround(foundEffectsNegative[substitutedPrecondition._usig._name_id], groundFact, freeArgRestrictions) || !_init_facts.contains(groundFact)) {
                         preconditionsValid = true;
                         break;
                     }
@@ -294,16 +336,16 @@ SigSet FactAnalysis::groundEffects(const NodeHashMap<int, USigSet>& effects, boo
     return result;
 }
 
-std::vector<FlatHashSet<int>> FactAnalysis::getReducedArgumentDomains(const HtnOp& op) {
+std::vector<FlatHashSet<int>> FactAnalysis::getReducedArgumentDomains(const GroundOp& op) {
     const std::vector<int>& args = op.getArguments();
     const std::vector<int>& sorts = _htn.getSorts(op.getNameId());
     std::vector<FlatHashSet<int>> domainPerVariable(args.size());
     std::vector<bool> occursInPreconditions(args.size(), false);
 
     // Check each precondition regarding its valid decodings w.r.t. current state
-    //const SigSet* preSets[2] = {&op.getPreconditions(), &op.getExtraPreconditions()};
-    const SigSet* preSets[1] = {&op.getPreconditions()};
-    for (const auto& preSet : preSets) for (const auto& preSig : *preSet) {
+    std::vector<Signature> preconditions;
+    op.forEachPrecondition([&](Signature&& pre) {preconditions.push_back(std::move(pre));});
+    for (const auto& preSig : preconditions) {
 
         // Find mapping from precond args to op args
         std::vector<int> opArgIndices(preSig._usig._args.size(), -1);
@@ -341,12 +383,15 @@ std::vector<FlatHashSet<int>> FactAnalysis::getReducedArgumentDomains(const HtnO
         // Check possible decodings of precondition
         bool any = false;
         bool anyValid = false;
-        for (const auto& decUSig : _htn.decodeObjects(preSig._usig, _htn.getEligibleArgs(preSig._usig, preSorts))) {
+        auto eligibleArgs = _htn.getEligibleArgs(preSig._usig, preSorts);
+        Bitset reachable = getReachableDecodings(preSig._usig, eligibleArgs, preSig._negated);
+        size_t decIdx = 0;
+        for (const auto& decUSig : _htn.decodeObjects(preSig._usig, std::move(eligibleArgs))) {
             any = true;
             assert(_htn.isFullyGround(decUSig));
 
             // Valid?
-            if (!isReachable(decUSig, preSig._negated)) continue;
+            if (!reachable.test(decIdx++)) continue;
             
             // Valid precondition decoding found: Increase domain of concerned variables
             anyValid = true;
@@ -6,6 +6,9 @@
 #include "algo/network_traversal.h"
 #include "algo/arg_iterator.h"
 #include "algo/compute_fact_frame.h"
+#include "algo/rigid_predicate_index.h"
+#include "data/fact_index.h"
+#include "util/bitset.h"
 
 typedef std::function<bool(const USignature&, bool)> StateEvaluator;
 
@@ -14,9 +17,6 @@ class FactAnalysis {
 private:
     NetworkTraversal _traversal;
 
-    USigSet _initialized_facts;
-    USigSet _relevant_facts;
-
     // Maps an (action|reduction) name 
     // to the set of (partially lifted) fact signatures
     // that might be added to the state due to this operator. 
@@ -43,17 +43,30 @@ protected:
     int _nodes_variables_restricted = 0;
 
     HtnInstance& _htn;
-    USigSet _pos_layer_facts;
-    USigSet _neg_layer_facts;
+    FactIndex _fact_index;
+    DenseFactSet _init_facts;
+    DenseFactSet _pos_layer_facts;
+    DenseFactSet _neg_layer_facts;
+    std::vector<size_t> _decoding_ids;
     
     int _new_variable_domain_size_limit = 1;
 
     NodeHashMap<int, USigSet> _final_effects_positive;
     NodeHashMap<int, USigSet> _final_effects_negative;
     int _name_id_;
+
+private:
+    // Declared after _fact_index which they are constructed from
+    DenseFactSet _initialized_facts;
+    DenseFactSet _relevant_facts;
+
 public:
-    FactAnalysis(HtnInstance& htn, Parameters& params) : _htn(htn), _traversal(htn), _init_state(htn.getInitState()), _util(htn, _fact_frames, _traversal), 
-        _new_variable_domain_size_limit(params.getIntParam("pfcRestrictLimit")), _name_id_(_htn.nameId("??_")) {
+    FactAnalysis(HtnInstance& htn, Parameters& params) : _traversal(htn), _util(htn, _fact_frames, _traversal), 
+        _init_state(htn.getInitState()), _htn(htn), _fact_index(htn), _init_facts(_fact_index), 
+        _pos_layer_facts(_fact_index), _neg_layer_facts(_fact_index), 
+        _new_variable_domain_size_limit(params.getIntParam("pfcRestrictLimit")), _name_id_(_htn.nameId("??_")),
+        _initialized_facts(_fact_index), _relevant_facts(_fact_index) {
+        for (const auto& fact : _init_state) _init_facts.insert(fact);
         resetReachability();
     }
 
@@ -81,6 +94,13 @@ public:
         _fact_changes_cache.clear();
     }
 
+    int getVariableDomainSizeLimit() const {
+        return _new_variable_domain_size_limit;
+    }
+    void setVariableDomainSizeLimit(int limit) {
+        _new_variable_domain_size_limit = limit;
+    }
+
     int getRigidPredicatesMatched() {
         return _rigid_predicates_matched;
     }
@@ -126,7 +146,7 @@ public:
     }
 
     void resetReachability() {
-        _pos_layer_facts = _init_state;
+        _pos_layer_facts.assign(_init_facts);
         _neg_layer_facts.clear();
         _initialized_facts.clear();
         _fact_changes_cache = NodeHashMap<USignature, SigSet, USignatureHasher>();
@@ -146,14 +166,26 @@ public:
     bool isReachable(const Signature& fact) {
         return isReachable(fact._usig, fact._negated);
     }
+
+    // Order-independent hash of the facts which are currently reachable
+    uint64_t getReachabilityFingerprint() const {
+        uint64_t neg = _neg_layer_facts.getFingerprint();
+        return _pos_layer_facts.getFingerprint() ^ ((neg << 1) | (neg >> 63));
+    }
     
     bool isReachable(const USignature& fact, bool negated) {
         if (negated) {
-            return _neg_layer_facts.count(fact) || !_init_state.count(fact);
+            return _neg_layer_facts.contains(fact) || !_init_facts.contains(fact);
         }
-        return _pos_layer_facts.count(fact);
+        return _pos_layer_facts.contains(fact);
     }
 
+    // Checks the reachability of all decodings of a q-fact at once. Bit i of the result
+    // is set iff the i-th decoding (in the order of ArgIterator) is reachable.
+    Bitset getReachableDecodings(const USignature& qFact, const std::vector<std::vector<int>>& eligibleArgs, bool negated);
+    // Bit i of the result is set iff the i-th decoding has not been initialized yet.
+    Bitset getUninitializedDecodings(const USignature& qFact, const std::vector<std::vector<int>>& eligibleArgs);
+
     bool countPositive(NodeHashMap<int, USigSet>& effects, USignature& usig, NodeHashMap<int, FlatHashSet<int>>& freeArgRestrictions) {
         if (_htn.isFullyGround(usig) && !_htn.hasQConstants(usig)) return countPositiveGround(effects[usig._name_id], usig, freeArgRestrictions);
         if (effects[usig._name_id].count(usig)) return true;
@@ -201,10 +233,10 @@ public:
     }
 
     bool isRelevant(const USignature& fact) {
-        return _relevant_facts.count(fact);
+        return _relevant_facts.contains(fact);
     }
 
-    const USigSet& getRelevantFacts() {
+    const DenseFactSet& getRelevantFacts() {
         return _relevant_facts;
     }
 
@@ -216,24 +248,28 @@ public:
     }
 
     bool isInitialized(const USignature& fact) {
-        return _initialized_facts.count(fact);
+        return _initialized_facts.contains(fact);
+    }
+
+    // The initial state as a set of signatures is only needed
+    // for computing the fact frames; afterwards, _init_facts suffices.
+    void releaseInitState() {
+        _init_state.clear();
+        _init_state.reserve(0);
     }
 
     SigSet inferPreconditions(const USignature& op) {
         return _util.getFactFrame(op).preconditions;
     }
 
-    std::vector<FlatHashSet<int>> getReducedArgumentDomains(const HtnOp& op);
+    std::vector<FlatHashSet<int>> getReducedArgumentDomains(const GroundOp& op);
 
     inline bool isPseudoOrGroundFactReachable(const USignature& sig, bool negated) {
         if (!_htn.isFullyGround(sig)) return true;
         
         // Q-Fact:
         if (_htn.hasQConstants(sig)) {
-            for (const auto& decSig : _htn.decodeObjects(sig, _htn.getEligibleArgs(sig))) {
-                if (isReachable(decSig, negated)) return true;
-            }
-            return false;
+            return getReachableDecodings(sig, _htn.getEligibleArgs(sig), negated).any();
         }
 
         return isReachable(sig, negated);
@@ -274,7 +310,7 @@ public:
     
     bool restrictNewVariables(SigSet& preconditions, SigSet& fluentPreconditions, Substitution& s, 
         NodeHashMap<int, FlatHashSet<int>>& freeArgRestrictions, 
-        FlatHashMap<int, FlatHashMap<USignature, FlatHashSet<int>, USignatureHasher>>& rigid_predicate_cache, FlatHashSet<int> nodeArgs,
+        const RigidPredicateIndex& rigidPredicateIndex, FlatHashSet<int> nodeArgs,
         NodeHashMap<int, USigSet>& foundEffectsPositive, NodeHashMap<int, USigSet>& foundEffectsNegative, 
         NodeHashMap<int, SigSet>& postconditions, Substitution& globalSub);
     USigSet removeDominated(const NodeHashMap<int, USigSet>& originalSignatures);
@@ -76,6 +76,9 @@ std::vector<USignature> Instantiator::instantiate(const HtnOp& op) {
         }
     }*/
 
+    // Nothing to instantiate: just check the op's validity
+    if (argIndicesByPriority.empty()) return instantiateLimited(op, argIndicesByPriority, 0, false);
+
     // a) Try to naively ground _one single_ instantiation
     // -- if this fails, there is no valid instantiation at all
     std::vector<USignature> inst = instantiateLimited(op, argIndicesByPriority, 1, /*returnUnfinished=*/true);
@@ -241,9 +244,11 @@ const FlatHashMap<int, float>& Instantiator::getPreconditionRatings(const USigna
         
         NetworkTraversal(_htn).traverse(normSig, NetworkTraversal::TRAVERSE_PREORDER, [&](const USignature& nodeSig, int depth) {
 
-            HtnOp op = (_htn.isAction(nodeSig) ? 
-                        (HtnOp)_htn.toAction(nodeSig._name_id, nodeSig._args) : 
-                        (HtnOp)_htn.toReduction(nodeSig._name_id, nodeSig._args));
+            // Arguments of all (substituted) preconditions of the node
+            std::vector<int> precondArgs;
+            _htn.toGroundOp(nodeSig).forEachPrecondition([&](const Signature& pre) {
+                precondArgs.insert(precondArgs.end(), pre._usig._args.begin(), pre._usig._args.end());
+            });
             int numPrecondArgs = 0;
             int occs = 0;
             for (size_t i = 0; i < normSig._args.size(); i++) {
@@ -258,7 +263,7 @@ const FlatHashMap<int, float>& Instantiator::getPreconditionRatings(const USigna
                     numRatings[opArg].push_back(0);
                 }
 
-                for (const Signature& pre : op.getPreconditions()) for (const int& preArg : pre._usig._args) {
+                for (const int& preArg : precondArgs) {
                     if (normArg == preArg) occs++;
                     numPrecondArgs++;
                 }
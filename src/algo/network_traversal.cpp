@@ -68,13 +68,10 @@ void NetworkTraversal::traverse(const USignature& opSig, TraverseOrder order, st
 std::vector<USignature> NetworkTraversal::getPossibleChildren(const USignature& opSig) {
     std::vector<USignature> result;
 
-    int nameId = opSig._name_id;
     if (!_htn->isReduction(opSig)) return result;
 
     // Reduction
-    Reduction r = _htn->toReduction(nameId, opSig._args);
-
-    const std::vector<USignature>& subtasks = r.getSubtasks();
+    const std::vector<USignature> subtasks = _htn->toGroundOp(opSig).getSubtasks();
     for (size_t i = 0; i < subtasks.size(); i++) getPossibleChildren(subtasks, i, result);    
 
     return result;
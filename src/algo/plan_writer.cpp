@@ -36,7 +36,7 @@ void PlanWriter::outputPlan(Plan& _plan) {
             // Primitivized reduction: Replace with actual action, remember represented method to include in decomposition
 
             [[maybe_unused]] const auto& [parentId, childId] = _htn.getReductionAndActionFromPrimitivization(item.abstractTask._name_id);
-            const Reduction& parentRed = _htn.toReduction(parentId, item.abstractTask._args);
+            GroundOp parentRed = _htn.toGroundOp(USignature(parentId, item.abstractTask._args));
             primitivizationIds.insert(item.id);
             
             PlanItem parent;
@@ -46,8 +46,7 @@ void PlanWriter::outputPlan(Plan& _plan) {
             parent.subtaskIds = std::vector<int>(1, item.id);
             decompsToInsert.push_back(parent);
 
-            const USignature& childSig = parentRed.getSubtasks()[0];
-            item.abstractTask = childSig;
+            item.abstractTask = parentRed.getSubtask(0);
         }
 
         actionIds.insert(item.id);
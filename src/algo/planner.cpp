@@ -5,6 +5,7 @@
 #include "util/log.h"
 #include "util/signal_manager.h"
 #include "util/timer.h"
+#include "util/memusage.h"
 #include "sat/plan_optimizer.h"
 
 int terminateSatCall(void* state) {return ((Planner*) state)->getTerminateSatCall();}
@@ -22,10 +23,12 @@ int Planner::findPlan() {
     _sat_time_limit = _params.getFloatParam("stl");
 
     bool solved = false;
+    // Result of the last solving attempt with assumptions (-1: none yet)
+    int result = -1;
     _enc.setTerminateCallback(this, terminateSatCall);
     if (iteration >= firstSatCallIteration) {
         _enc.addAssumptions(_layer_idx);
-        int result = _enc.solve();
+        result = _enc.solve();
         if (result == 0) {
             Log::w("Solver was interrupted. Discarding time limit for next solving attempts.\n");
             _sat_time_limit = 0;
@@ -36,9 +39,24 @@ int Planner::findPlan() {
     // Next layers
     while (!solved && (maxIterations == 0 || iteration < maxIterations)) {
 
+        checkMemoryBudget();
+        if (isMemoryExhausted()) {
+            Log::w("Memory budget exhausted at layer %i - not expanding any further.\n", _layer_idx);
+            break;
+        }
+
         if (iteration >= firstSatCallIteration) {
 
-            _enc.printFailedVars(*_layers.back());
+            // Read the failed assumptions before pruning adds any clauses:
+            // IPASIR only defines ipasir_failed directly after an UNSAT call.
+            // After an interrupted call there is no core, and all positions are expanded.
+            if (result == 20) {
+                _enc.printFailedVars(*_layers.back());
+                if (_params.isNonzero("cge")) deferExpansions();
+            }
+            pruneLearntFalseOps();
+            // (pruning may have paged in or thawed past positions)
+            if (_spill_file) spillPastLayers();
 
             if (_params.isNonzero("cs")) { // check solvability
                 Log::i("Not solved at layer %i with assumptions\n", _layer_idx);
@@ -64,7 +82,7 @@ int Planner::findPlan() {
 
         if (iteration >= firstSatCallIteration) {
             _enc.addAssumptions(_layer_idx);
-            int result = _enc.solve();
+            result = _enc.solve();
             if (result == 0) {
                 Log::w("Solver was interrupted. Discarding time limit for next solving attempts.\n");
                 _sat_time_limit = 0;
@@ -74,7 +92,7 @@ int Planner::findPlan() {
     }
 
     if (!solved) {
-        if (iteration >= firstSatCallIteration) _enc.printFailedVars(*_layers.back());
+        if (result == 20) _enc.printFailedVars(*_layers.back());
         Log::w("No success. Exiting.\n");
         return 1;
     }
@@ -111,10 +129,16 @@ void Planner::improvePlan(int& iteration) {
             do {
                 // Extra layers without solving
                 for (size_t x = 0; x < el && (maxIterations == 0 || iteration < maxIterations); x++) {
+                    checkMemoryBudget();
+                    if (isMemoryExhausted()) break;
                     iteration++;      
                     Log::i("Iteration %i. (extra)\n", iteration);
                     createNextLayer();
                 }
+                if (isMemoryExhausted()) {
+                    Log::w("Memory budget exhausted - keeping best plan found so far.\n");
+                    break;
+                }
                 // Solve again (to get another plan)
                 _enc.addAssumptions(_layer_idx);
                 int result = _enc.solve();
@@ -138,6 +162,11 @@ void Planner::improvePlan(int& iteration) {
         } else {
             // Extra layers without solving
             for (int x = 0; x < extraLayers; x++) {
+                checkMemoryBudget();
+                if (isMemoryExhausted()) {
+                    Log::w("Memory budget exhausted - no further extra layers.\n");
+                    break;
+                }
                 iteration++;      
                 Log::i("Iteration %i. (extra)\n", iteration);
                 createNextLayer();
@@ -194,13 +223,12 @@ void Planner::createFirstLayer() {
 
     // Instantiate all possible init. reductions
     for (USignature& rSig : _instantiator.getApplicableInstantiations(_htn.getInitReduction())) {
-        auto rOpt = createValidReduction(rSig, USignature());
-        if (rOpt) {
-            auto& r = rOpt.value();
-            USignature sig = r.getSignature();
+        auto sigOpt = createValidReduction(rSig, USignature());
+        if (sigOpt) {
+            const USignature& sig = sigOpt.value();
             initLayer[_pos].addReduction(sig);
             initLayer[_pos].addAxiomaticOp(sig);
-            initLayer[_pos].addExpansionSize(r.getSubtasks().size());
+            initLayer[_pos].addExpansionSize(_htn.getOpTable().getReduction(sig).getSubtasks().size());
         }
     }
     addPreconditionConstraints();
@@ -264,6 +292,7 @@ void Planner::createNextLayer() {
 
             incrementPosition();
             checkTermination();
+            checkMemoryBudget();
         }
     }
     if (_pos > 0) _layers[_layer_idx]->at(_pos-1).clearAfterInstantiation();
@@ -280,10 +309,14 @@ void Planner::createNextLayer() {
             Log::v("- Position (%i,%i)\n", _layer_idx, _pos);
             _enc.encode(_layer_idx, _pos);
             clearDonePositions(offset);
+            checkMemoryBudget();
         }
     }
 
     newLayer.consolidate();
+
+    // The layers above the previous layer are not accessed by encoding anymore
+    if (_spill_file) spillPastLayers();
 }
 
 void Planner::createNextPosition() {
@@ -363,9 +396,7 @@ void Planner::createNextPositionFromLeft(Position& left) {
         isAction = false;
     }
 
-    for (const auto& aSig : actionsToRemove) {
-        _pruning.prune(aSig, _layer_idx, _pos-1);
-    }
+    _pruning.prune(std::vector<USignature>(actionsToRemove.begin(), actionsToRemove.end()), _layer_idx, _pos-1);
 }
 
 void Planner::addPreconditionConstraints() {
@@ -394,29 +425,6 @@ void Planner::addPreconditionsAndConstraints(const USignature& op, const SigSet&
         if (cOpt) newPos.addSubstitutionConstraint(constrOp, std::move(cOpt.value()));
     }
     if (!isRepetition) addQConstantTypeConstraints(op);
-
-    if (!newPos.getSubstitutionConstraints().count(op)) return;
-
-    // Merge substitution constraints as far as possible
-    auto& constraints = newPos.getSubstitutionConstraints().at(op);
-    //Log::d("MERGE? %i constraints\n", constraints.size());
-    for (size_t i = 0; i < constraints.size(); i++) {
-        for (size_t j = i+1; j < constraints.size(); j++) {
-            auto& iTree = constraints[i];
-            auto& jTree = constraints[j];
-            if (iTree.canMerge(jTree)) {
-                //Log::d("MERGE %s %i,%i sizes %i,%i\n", 
-                //    iTree.getPolarity() == SubstitutionConstraint::ANY_VALID ? "ANY_VALID" : "NO_INVALID", 
-                //    i, j, iTree.getEncodedSize(), jTree.getEncodedSize());
-                iTree.merge(std::move(jTree));
-                //Log::d("MERGED: new size %i\n", iTree.getEncodedSize());
-                if (j+1 < constraints.size()) 
-                    constraints[j] = std::move(constraints.back());
-                constraints.erase(constraints.begin()+constraints.size()-1);
-                j--;
-            }
-        }
-    }
 }
 
 std::optional<SubstitutionConstraint> Planner::addPrecondition(const USignature& op, const Signature& fact, bool addQFact) {
@@ -446,25 +454,28 @@ std::optional<SubstitutionConstraint> Planner::addPrecondition(const USignature&
     
     auto eligibleArgs = _htn.getEligibleArgs(factAbs, sorts);
 
+    // Reachability of each decoding, and of each decoding's negation
+    Bitset reachable = _analysis->getReachableDecodings(factAbs, eligibleArgs, fact._negated);
+    Bitset negReachable = _analysis->getReachableDecodings(factAbs, eligibleArgs, !fact._negated);
+
     auto polarity = SubstitutionConstraint::UNDECIDED;
-    size_t totalSize = 1; for (auto& args : eligibleArgs) totalSize *= args.size();
+    size_t totalSize = reachable.size();
     size_t sampleSize = 25;
     bool doSample = totalSize > 2*sampleSize;
     if (doSample) {
-        size_t valids = 0;
-        // Check out a random sample of the possible decoded objects
-        for (const USignature& decFactAbs : _htn.decodeObjects(factAbs, eligibleArgs, sampleSize)) {
-            if (_analysis->isReachable(decFactAbs, fact._negated)) valids++;
-        }
-        polarity = valids < sampleSize/2 ? SubstitutionConstraint::ANY_VALID : SubstitutionConstraint::NO_INVALID;
+        // Decide polarity based on the number of valid decodings
+        size_t valids = reachable.count();
+        polarity = valids < totalSize/2 ? SubstitutionConstraint::ANY_VALID : SubstitutionConstraint::NO_INVALID;
         c.fixPolarity(polarity);
     }
 
     // For each fact decoded from the q-fact:
+    size_t decIdx = 0;
     for (const USignature& decFactAbs : _htn.decodeObjects(factAbs, eligibleArgs)) {
+        size_t idx = decIdx++;
 
         // Can the decoded fact occur as is?
-        if (_analysis->isReachable(decFactAbs, fact._negated)) {
+        if (reachable.test(idx)) {
             if (polarity != SubstitutionConstraint::NO_INVALID)
                 c.addValid(SubstitutionConstraint::decodingToPath(factAbs._args, decFactAbs._args, sortedArgIndices));
         } else {
@@ -475,7 +486,7 @@ std::optional<SubstitutionConstraint> Planner::addPrecondition(const USignature&
         }
 
         // If the fact is reachable, is it even invariant?
-        if (_analysis->isInvariant(decFactAbs, fact._negated)) {
+        if (!negReachable.test(idx)) {
             // Yes! This precondition is trivially satisfied 
             // with above substitution restrictions
             continue;
@@ -534,18 +545,19 @@ bool Planner::addEffect(const USignature& opSig, const Signature& fact, EffectMo
     
     std::vector<int> involvedQConsts(sortedArgIndices.size());
     for (size_t i = 0; i < sortedArgIndices.size(); i++) involvedQConsts[i] = factAbs._args[sortedArgIndices[i]];
-    std::vector<SubstitutionConstraint*> fittingConstrs, otherConstrs;
+    std::vector<const SubstitutionConstraint*> fittingConstrs, otherConstrs;
     if (isConstrained) {
-        for (auto& c : left.getSubstitutionConstraints().at(opSig)) {
-            if (c.getInvolvedQConstants() == involvedQConsts) fittingConstrs.push_back(&c);
-            else if (c.getPolarity() == SubstitutionConstraint::NO_INVALID || c.involvesSupersetOf(involvedQConsts)) 
-                otherConstrs.push_back(&c);
-        }
+        left.getSubstitutionConstraints().at(opSig).getApplicableConstraints(involvedQConsts, fittingConstrs, otherConstrs);
     }
     
+    auto eligibleArgs = _htn.getEligibleArgs(factAbs, sorts);
+    Bitset negReachable = _analysis->getReachableDecodings(factAbs, eligibleArgs, !fact._negated);
+
     bool anyGood = false;
     bool staticallyResolvable = true;
-    for (const USignature& decFactAbs : _htn.decodeObjects(factAbs, _htn.getEligibleArgs(factAbs, sorts))) {
+    size_t decIdx = 0;
+    for (const USignature& decFactAbs : _htn.decodeObjects(factAbs, std::move(eligibleArgs))) {
+        size_t idx = decIdx++;
 
         auto path = SubstitutionConstraint::decodingToPath(factAbs._args, decFactAbs._args, sortedArgIndices);
 
@@ -568,7 +580,7 @@ bool Planner::addEffect(const USignature& opSig, const Signature& fact, EffectMo
         }
 
         anyGood = true;
-        if (_analysis->isInvariant(decFactAbs, fact._negated)) {
+        if (!negReachable.test(idx)) {
             // Effect holds trivially
             continue;
         }
@@ -636,9 +648,7 @@ void Planner::propagateActions(size_t offset) {
     }
 
     // Prune invalid actions at above position
-    for (const auto& aSig : actionsToPrune) {
-        _pruning.prune(aSig, _layer_idx-1, _old_pos);
-    }
+    _pruning.prune(actionsToPrune, _layer_idx-1, _old_pos);
     assert(above.getActions().size() == numActionsBefore - actionsToPrune.size() 
         || Log::e("%i != %i-%i\n", above.getActions().size(), numActionsBefore, actionsToPrune.size()));
 
@@ -673,10 +683,20 @@ void Planner::propagateReductions(size_t offset) {
     NodeHashMap<USignature, USigSet, USignatureHasher> subtaskToParents;
     NodeHashSet<USignature, USignatureHasher> reductionsWithChildren;
 
+    if (above.isDeferred()) {
+        // Expansion of the above position is deferred: repeat each reduction
+        for (const auto& rSig : above.getReductions()) {
+            newPos.addReduction(rSig);
+            newPos.addExpansionSize(_htn.getOpTable().getReduction(rSig).getSubtasks().size());
+            newPos.addExpansion(rSig, rSig);
+        }
+        return;
+    }
+
     // Collect all possible subtasks and remember their possible parents
     for (const auto& rSig : above.getReductions()) {
 
-        const Reduction r = _htn.getOpTable().getReduction(rSig);
+        const Reduction& r = _htn.getOpTable().getReduction(rSig);
         
         if (offset < r.getSubtasks().size()) {
             // Proper expansion
@@ -694,17 +714,11 @@ void Planner::propagateReductions(size_t offset) {
     // Iterate over all possible subtasks
     for (const auto& [subtask, parents] : subtaskToParents) {
 
-        // Calculate all possible actions fitting the subtask.
-        auto allActions = instantiateAllActionsOfTask(subtask);
+        // Calculate all possible actions and reductions fitting the subtask.
+        auto [allActions, allReductions] = instantiateSubtask(subtask);
 
         // Any reduction(s) fitting the subtask?
-        for (const USignature& subRSig : instantiateAllReductionsOfTask(subtask)) {
-
-            if (_htn.isAction(subRSig)) {
-                // Actually an action, not a reduction: remember for later
-                allActions.push_back(subRSig);
-                continue;
-            }
+        for (const USignature& subRSig : allReductions) {
 
             const Reduction& subR = _htn.getOpTable().getReduction(subRSig);
             
@@ -732,13 +746,58 @@ void Planner::propagateReductions(size_t offset) {
     }
 
     // Check if any reduction has no valid children at all
+    std::vector<USignature> reductionsToPrune;
     for (const auto& rSig : above.getReductions()) {
         if (!reductionsWithChildren.count(rSig)) {
             Log::i("Retroactively prune reduction %s@(%i,%i): no children at offset %i\n", 
                     TOSTR(rSig), _layer_idx-1, _old_pos, offset);
-            _pruning.prune(rSig, _layer_idx-1, _old_pos);
+            reductionsToPrune.push_back(rSig);
+        }
+    }
+    _pruning.prune(reductionsToPrune, _layer_idx-1, _old_pos);
+}
+
+Planner::SubtaskInstantiation Planner::instantiateSubtask(const USignature& subtask) {
+
+    // Instantiation only depends on the subtask and on the reachable facts
+    uint64_t fingerprint = _analysis->getReachabilityFingerprint();
+    if (_subtask_cache_limit > 0) {
+        auto it = _subtask_cache.find(subtask);
+        if (it != _subtask_cache.end()) {
+            auto fIt = it->second.find(fingerprint);
+            if (fIt != it->second.end()) {
+                _num_subtask_cache_hits++;
+                return fIt->second;
+            }
+        }
+    }
+
+    SubtaskInstantiation inst;
+    inst.actions = instantiateAllActionsOfTask(subtask);
+    for (const USignature& subRSig : instantiateAllReductionsOfTask(subtask)) {
+        // Actually an action, not a reduction?
+        if (_htn.isAction(subRSig)) inst.actions.push_back(subRSig);
+        else inst.reductions.push_back(subRSig);
+    }
+    if (_subtask_cache_limit == 0) return inst;
+
+    // Ops with q-constants introduced at this position cannot be reused elsewhere
+    IntPair origin(_layer_idx, _pos);
+    for (const auto* ops : {&inst.actions, &inst.reductions}) for (const USignature& sig : *ops) {
+        for (int arg : sig._args) if (_htn.isQConstant(arg) && _htn.getOriginOfQConstant(arg) == origin) {
+            _num_subtask_cache_uncacheable++;
+            return inst;
         }
     }
+
+    _num_subtask_cache_misses++;
+    if (_subtask_cache_size >= _subtask_cache_limit) {
+        _subtask_cache.clear();
+        _subtask_cache_size = 0;
+    }
+    _subtask_cache[subtask][fingerprint] = inst;
+    _subtask_cache_size++;
+    return inst;
 }
 
 std::vector<USignature> Planner::instantiateAllActionsOfTask(const USignature& task) {
@@ -748,10 +807,10 @@ std::vector<USignature> Planner::instantiateAllActionsOfTask(const USignature& t
     
     for (USignature& sig : _instantiator.getApplicableInstantiations(_htn.toAction(task._name_id, task._args))) {
         //Log::d("ADDACTION %s ?\n", TOSTR(action.getSignature()));
-        Action action = _htn.toAction(sig._name_id, sig._args);
-
         // Rename any remaining variables in each action as unique q-constants,
-        action = _htn.replaceVariablesWithQConstants(action, _analysis->getReducedArgumentDomains(action), _layer_idx, _pos);
+        // substituting the lifted action only once
+        auto domains = _analysis->getReducedArgumentDomains(_htn.toGroundOp(sig));
+        Action action = _htn.toAction(sig._name_id, _htn.replaceVariablesWithQConstants(sig, domains, _layer_idx, _pos));
 
         // Remove any contradictory ground effects that were just created
         action.removeInconsistentEffects();
@@ -764,8 +823,8 @@ std::vector<USignature> Planner::instantiateAllActionsOfTask(const USignature& t
         
         // Action is valid
         sig = action.getSignature();
-        _htn.getOpTable().addAction(action);
-        result.push_back(action.getSignature());
+        result.push_back(sig);
+        _htn.getOpTable().addAction(std::move(action));
     }
     return result;
 }
@@ -802,21 +861,20 @@ std::vector<USignature> Planner::instantiateAllReductionsOfTask(const USignature
             if (!_htn.hasConsistentlyTypedArgs(origSig)) continue;
             
             for (USignature& red : _instantiator.getApplicableInstantiations(rSub)) {
-                auto rOpt = createValidReduction(red, task);
-                if (rOpt) result.push_back(rOpt.value().getSignature());
+                auto sigOpt = createValidReduction(red, task);
+                if (sigOpt) result.push_back(std::move(sigOpt.value()));
             }
         }
     }
     return result;
 }
 
-std::optional<Reduction> Planner::createValidReduction(const USignature& sig, const USignature& task) {
-    std::optional<Reduction> rOpt;
+std::optional<USignature> Planner::createValidReduction(const USignature& sig, const USignature& task) {
+    std::optional<USignature> sigOpt;
 
     // Rename any remaining variables in each action as new, unique q-constants 
-    Reduction red = _htn.toReduction(sig._name_id, sig._args);
-    auto domains = _analysis->getReducedArgumentDomains(red);
-    red = _htn.replaceVariablesWithQConstants(red, domains, _layer_idx, _pos);
+    auto domains = _analysis->getReducedArgumentDomains(_htn.toGroundOp(sig));
+    Reduction red = _htn.toReduction(sig._name_id, _htn.replaceVariablesWithQConstants(sig, domains, _layer_idx, _pos));
 
     // Check validity
     bool isValid = true;
@@ -827,10 +885,10 @@ std::optional<Reduction> Planner::createValidReduction(const USignature& sig, co
     else if (!_analysis->hasValidPreconditions(red.getExtraPreconditions())) isValid = false;
 
     if (isValid) {
-        _htn.getOpTable().addReduction(red);
-        rOpt.emplace(red);
+        sigOpt.emplace(red.getSignature());
+        _htn.getOpTable().addReduction(std::move(red));
     }
-    return rOpt;
+    return sigOpt;
 }
 
 void Planner::initializeNextEffects() {
@@ -853,9 +911,13 @@ void Planner::initializeNextEffects() {
                         initializeFact(newPos, eff._usig); 
                     } else {
                         std::vector<int> sorts = _htn.getOpSortsForCondition(eff._usig, aSig);
-                        for (const USignature& decEff : _htn.decodeObjects(eff._usig, _htn.getEligibleArgs(eff._usig, sorts))) {           
+                        auto eligibleArgs = _htn.getEligibleArgs(eff._usig, sorts);
+                        Bitset uninitialized = _analysis->getUninitializedDecodings(eff._usig, eligibleArgs);
+                        if (!uninitialized.any()) continue;
+                        size_t decIdx = 0;
+                        for (const USignature& decEff : _htn.decodeObjects(eff._usig, std::move(eligibleArgs))) {
                             // New ground fact: set before the action may happen
-                            initializeFact(newPos, decEff);
+                            if (uninitialized.test(decIdx++)) initializeFact(newPos, decEff);
                         }
                     }
                 }
@@ -871,9 +933,7 @@ void Planner::initializeNextEffects() {
         }
         isAction = false;
     }
-    for (const auto& opSig : opsToPrune) {
-        _pruning.prune(opSig, _layer_idx, _pos);
-    }
+    _pruning.prune(std::vector<USignature>(opsToPrune.begin(), opsToPrune.end()), _layer_idx, _pos);
 }
 
 void Planner::initializeFact(Position& newPos, const USignature& fact) {
@@ -921,6 +981,118 @@ void Planner::clearDonePositions(int offset) {
     if (positionToClearAbove != nullptr) {
         Log::v("  Freeing most memory of (%i,%i) ...\n", positionToClearAbove->getLayerIndex(), positionToClearAbove->getPositionIndex());
         positionToClearAbove->clearAtPastLayer();
+        if (_freeze_past_layers) {
+            positionToClearAbove->freeze();
+            _num_frozen_positions++;
+        }
+    }
+}
+
+void Planner::pruneLearntFalseOps() {
+    std::vector<int> falseVars = _enc.extractLearntFalseVars();
+    if (falseVars.empty()) return;
+    FlatHashSet<int> falseVarSet(falseVars.begin(), falseVars.end());
+
+    Layer& layer = *_layers.back();
+    size_t numPrunedBefore = _pruning.getNumRetroactivelyPrunedOps();
+    size_t numLearntFalseOps = 0;
+    for (size_t pos = 0; pos < layer.size(); pos++) {
+        Position& position = layer[pos];
+        std::vector<USignature> deadOps;
+        position.forEachOpVariable([&](const USignature& sig, int var) {
+            if (!falseVarSet.count(var)) return;
+            // (may have been pruned already)
+            if (position.hasReduction(sig)) {
+                _num_subtasks_avoided_by_learnt_units += _htn.getOpTable().getReduction(sig).getSubtasks().size();
+            } else if (!position.hasAction(sig)) return;
+            deadOps.push_back(sig);
+        });
+        _pruning.prune(deadOps, layer.index(), pos);
+        numLearntFalseOps += deadOps.size();
+    }
+    _num_ops_learnt_false += numLearntFalseOps;
+    _num_ops_pruned_by_learnt_units += _pruning.getNumRetroactivelyPrunedOps() - numPrunedBefore;
+    Log::i("Pruned %i ops learnt to be impossible (%i ops in total)\n", 
+            numLearntFalseOps, _pruning.getNumRetroactivelyPrunedOps() - numPrunedBefore);
+}
+
+void Planner::deferExpansions() {
+    Layer& layer = *_layers.back();
+
+    // Positions whose primitiveness assumption is part of the failed core
+    std::vector<bool> failed = _enc.getFailedPositions(layer);
+    if (std::find(failed.begin(), failed.end(), true) == failed.end()) return;
+
+    // Only expand the reductions at these positions; repeat all others
+    size_t numDeferred = 0;
+    for (size_t pos = 0; pos < layer.size(); pos++) {
+        bool defer = !failed[pos] && !layer[pos].getReductions().empty();
+        layer[pos].setDeferred(defer);
+        if (defer) numDeferred++;
+    }
+    layer.consolidate();
+    _num_deferred_positions += numDeferred;
+    Log::i("Deferring expansion of %i/%i positions outside of the failed core\n", numDeferred, layer.size());
+}
+
+void Planner::spillPastLayers() {
+    // Spills all positions above the previous layer, including positions which 
+    // were spilled before but have been paged in or thawed since then
+    size_t sizeBefore = _spill_file->size();
+    size_t numSpilled = 0;
+    for (size_t layerIdx = 0; layerIdx+2 <= _layer_idx; layerIdx++) {
+        Layer& layer = *_layers.at(layerIdx);
+        for (size_t pos = 0; pos < layer.size(); pos++) {
+            if (layer[pos].isSpilled()) continue;
+            layer[pos].spill(*_spill_file);
+            numSpilled++;
+        }
+    }
+    _num_spilled_positions += numSpilled;
+    if (numSpilled > 0) Log::v("Spilled %i positions of past layers (%i bytes written)\n", 
+            numSpilled, _spill_file->size() - sizeBefore);
+}
+
+void Planner::checkMemoryBudget() {
+    if (_memory_budget <= 0 || isMemoryExhausted()) return;
+
+    double vm, rss;
+    process_mem_usage(vm, rss);
+    rss /= 1024; // MB
+    _max_sampled_rss = std::max(_max_sampled_rss, rss);
+
+    // Enter each stage whose threshold (as a fraction of the budget) is reached
+    const float thresholds[] = {0, 0.6, 0.7, 0.8, 0.9};
+    while (_memory_stage < MEM_EXHAUSTED && rss >= thresholds[_memory_stage+1] * _memory_budget) {
+        _memory_stage = MemoryStage(_memory_stage+1);
+        _memory_decisions.push_back(MemoryDecision{_memory_stage, _layer_idx, _pos, rss});
+
+        switch (_memory_stage) {
+        case MEM_CACHES_DROPPED:
+            Log::w("RSS %.1f/%.1f MB: Dropping PFC and subtask instantiation caches\n", rss, _memory_budget);
+            _analysis->resetPFCCache();
+            _subtask_cache.clear();
+            _subtask_cache_size = 0;
+            _subtask_cache_limit = 0;
+            break;
+        case MEM_LIMITS_LOWERED: {
+            int limit = std::max(1, _analysis->getVariableDomainSizeLimit() / 4);
+            Log::w("RSS %.1f/%.1f MB: Lowering PFC variable restriction limit to %i\n", rss, _memory_budget, limit);
+            _analysis->setVariableDomainSizeLimit(limit);
+            break;
+        }
+        case MEM_LAYERS_SPILLED:
+            Log::w("RSS %.1f/%.1f MB: Freezing and spilling past layers\n", rss, _memory_budget);
+            _freeze_past_layers = true;
+            if (!_spill_file) _spill_file.reset(new SpillFile(_params.getParam("spd")));
+            spillPastLayers();
+            break;
+        case MEM_EXHAUSTED:
+            Log::w("RSS %.1f/%.1f MB: Stopping expansion after the current layer\n", rss, _memory_budget);
+            break;
+        default:
+            break;
+        }
     }
 }
 
@@ -985,7 +1157,46 @@ void Planner::printStatistics() {
     Log::i("# introduced pseudo-constants: %i\n", _htn.getNumberOfQConstants());
     Log::i("# retroactive prunings: %i\n", _pruning.getNumRetroactivePunings());
     Log::i("# retroactively pruned operations: %i\n", _pruning.getNumRetroactivelyPrunedOps());
+    Log::i("# subtask instantiation cache hits: %i\n", _num_subtask_cache_hits);
+    Log::i("# subtask instantiation cache misses: %i\n", _num_subtask_cache_misses);
+    Log::i("# uncacheable subtask instantiations: %i\n", _num_subtask_cache_uncacheable);
+    Log::i("# seeded variable phases: %i\n", _enc.getNumSeededPhases());
+    Log::i("# non-decision variables: %i (%i frozen)\n", _enc.getNumAuxiliaryVars(), _enc.getNumInterfaceVars());
+    Log::i("# clauses dropped by encoder-side propagation: %i\n", _enc.getSatInterface().getNumDroppedClauses());
+    Log::i("# literals stripped by encoder-side propagation: %i\n", _enc.getSatInterface().getNumStrippedLiterals());
+    if (_enc.isLocalPreprocessing()) {
+        Log::i("# locally eliminated variables: %i\n", _enc.getSatInterface().getNumEliminatedVars());
+        Log::i("# locally subsumed clauses: %i\n", _enc.getSatInterface().getNumSubsumedClauses());
+    }
+    const auto& layerStats = _enc.getLayerStatistics();
+    for (size_t layerIdx = 0; layerIdx < layerStats.size(); layerIdx++) {
+        const auto& s = layerStats[layerIdx];
+        if (_enc.isLocalPreprocessing()) {
+            Log::i("# layer %i: %i -> %i clauses after local preprocessing (%.3fs), SAT solving %.3fs\n", layerIdx, 
+                s.numClausesBefore, s.numClausesAfter, s.preprocessingTime, s.solvingTime);
+        } else {
+            Log::i("# layer %i: SAT solving %.3fs\n", layerIdx, s.solvingTime);
+        }
+    }
+    Log::i("# ops learnt to be impossible: %i\n", _num_ops_learnt_false);
+    Log::i("# ops pruned due to learnt units: %i\n", _num_ops_pruned_by_learnt_units);
+    Log::i("# subtask expansions avoided due to learnt units: %i\n", _num_subtasks_avoided_by_learnt_units);
+    Log::i("# deferred position expansions: %i\n", _num_deferred_positions);
+    Log::i("# retired clause groups: %i\n", _enc.getSatInterface().getNumRetiredGroups());
+    Log::i("# variable metadata memory: %.3f MB\n", VariableDomain::getMetadataMemoryUsage() / (1024.0*1024.0));
+    Log::i("# frozen positions: %i\n", _num_frozen_positions);
+    Log::i("# spilled positions: %i\n", _num_spilled_positions);
+    if (_spill_file) Log::i("# spill file size: %.3f MB\n", _spill_file->size() / (1024.0*1024.0));
+    if (_memory_budget > 0) {
+        const char* stageNames[] = {"ok", "caches dropped", "limits lowered", "layers spilled", "exhausted"};
+        Log::i("# max. sampled RSS: %.1f MB (budget: %.1f MB)\n", _max_sampled_rss, _memory_budget);
+        for (const auto& d : _memory_decisions) {
+            Log::i("# memory budget decision: %s at (%i,%i), RSS %.1f MB\n", stageNames[d.stage], d.layerIdx, d.pos, d.rss);
+        }
+    }
     Log::i("# dominated operations: %i\n", _domination_resolver.getNumDominatedOps());
+    Log::i("# domination comparisons: %i\n", _domination_resolver.getNumComparisons());
+    Log::i("# domination time: %.3fs\n", _domination_resolver.getTime());
     int total_rigid = _analysis->getInvalidRigidPreconditionsFound() + _analysis->getInvalidRigidPreconditionsFoundByVarRestriction();
     Log::i("# total invalid rigid preconditions found in getPFC: %i\n", total_rigid);
     Log::i("# invalid rigid preconditions found in getPFC: %i\n", _analysis->getInvalidRigidPreconditionsFound());
@@ -5,6 +5,7 @@
 #include "util/names.h"
 #include "util/params.h"
 #include "util/hashmap.h"
+#include "util/spill_file.h"
 #include "data/layer.h"
 #include "data/htn_instance.h"
 #include "algo/instantiator.h"
@@ -53,10 +54,46 @@ private:
     bool _has_plan;
     Plan _plan;
 
+    // Child operations of a subtask under a certain set of reachable facts
+    struct SubtaskInstantiation {
+        std::vector<USignature> actions;
+        std::vector<USignature> reductions;
+    };
+    // subtask -> reachability fingerprint -> instantiation
+    NodeHashMap<USignature, FlatHashMap<uint64_t, SubtaskInstantiation>, USignatureHasher> _subtask_cache;
+    size_t _subtask_cache_size = 0;
+    size_t _subtask_cache_limit;
+    bool _freeze_past_layers;
+    // scratch file for positions of fully encoded past layers (if enabled)
+    std::unique_ptr<SpillFile> _spill_file;
+
     // statistics
     size_t _num_instantiated_positions = 0;
     size_t _num_instantiated_actions = 0;
     size_t _num_instantiated_reductions = 0;
+    size_t _num_subtask_cache_hits = 0;
+    size_t _num_subtask_cache_misses = 0;
+    size_t _num_subtask_cache_uncacheable = 0;
+    size_t _num_frozen_positions = 0;
+    size_t _num_spilled_positions = 0;
+    size_t _num_deferred_positions = 0;
+    size_t _num_ops_learnt_false = 0;
+    size_t _num_ops_pruned_by_learnt_units = 0;
+    size_t _num_subtasks_avoided_by_learnt_units = 0;
+
+    // Memory budget (MB, 0: none) and the stages of graceful degradation
+    // which are entered as the resident set size approaches the budget
+    enum MemoryStage {MEM_OK, MEM_CACHES_DROPPED, MEM_LIMITS_LOWERED, MEM_LAYERS_SPILLED, MEM_EXHAUSTED};
+    float _memory_budget;
+    MemoryStage _memory_stage = MEM_OK;
+    double _max_sampled_rss = 0;
+    struct MemoryDecision {
+        MemoryStage stage;
+        size_t layerIdx;
+        size_t pos;
+        double rss;
+    };
+    std::vector<MemoryDecision> _memory_decisions;
 
 public:
     Planner(Parameters& params, HtnInstance& htn) : _params(params), _htn(htn),
@@ -68,7 +105,9 @@ public:
             _domination_resolver(_htn),
             _plan_writer(_htn, _params),
             _init_plan_time_limit(_params.getFloatParam("T")), _nonprimitive_support(_params.isNonzero("nps")), 
-            _optimization_factor(_params.getFloatParam("of")), _has_plan(false) {
+            _optimization_factor(_params.getFloatParam("of")), _has_plan(false), 
+            _subtask_cache_limit(_params.getIntParam("sic")), _freeze_past_layers(_params.isNonzero("fpl")),
+            _memory_budget(_params.getFloatParam("mem")) {
 
         // Make sure to create the goal action
         // before fact frames are computed
@@ -76,9 +115,12 @@ public:
 
         // Compute fact frame for every (lifted) operation
         _analysis->computeFactFrames();
+        _analysis->releaseInitState();
 
         // Infer additional preconditions for reductions from their subtasks
         PreconditionInference::infer(_htn, *_analysis, PreconditionInference::MinePrecMode(_params.getIntParam("mp")));
+
+        if (_params.isNonzero("spl")) _spill_file.reset(new SpillFile(_params.getParam("spd")));
     }
     int findPlan();
     void improvePlan(int& iteration);
@@ -105,11 +147,12 @@ private:
     enum EffectMode { INDIRECT, DIRECT, DIRECT_NO_QFACT };
     bool addEffect(const USignature& op, const Signature& fact, EffectMode mode);
 
-    std::optional<Reduction> createValidReduction(const USignature& rSig, const USignature& task);
+    std::optional<USignature> createValidReduction(const USignature& rSig, const USignature& task);
 
     void propagateInitialState();
     void propagateActions(size_t offset);
     void propagateReductions(size_t offset);
+    SubtaskInstantiation instantiateSubtask(const USignature& subtask);
     std::vector<USignature> instantiateAllActionsOfTask(const USignature& task);
     std::vector<USignature> instantiateAllReductionsOfTask(const USignature& task);
     void initializeNextEffects();
@@ -118,6 +161,11 @@ private:
 
     int getTerminateSatCall();
     void clearDonePositions(int offset);
+    void spillPastLayers();
+    void pruneLearntFalseOps();
+    void deferExpansions();
+    void checkMemoryBudget();
+    bool isMemoryExhausted() const {return _memory_stage == MEM_EXHAUSTED;}
     void printStatistics();
 
 };
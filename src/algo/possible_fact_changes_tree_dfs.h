@@ -146,7 +146,7 @@ public:
             SigSet subtitutedRigidPreconditions = ff.rigidPreconditions;
             SigSet subtitutedFluentPreconditions = ff.fluentPreconditions;
             size_t oldArgRestrictionSize = globalFreeArgRestrictions.size();
-            bool preconditionsValid = restrictNewVariables(subtitutedRigidPreconditions, subtitutedFluentPreconditions, newSub, globalFreeArgRestrictions, _preprocessing.getRigidPredicateCache(), 
+            bool preconditionsValid = restrictNewVariables(subtitutedRigidPreconditions, subtitutedFluentPreconditions, newSub, globalFreeArgRestrictions, _preprocessing.getRigidPredicateIndex(), 
                 child.newArgs, foundEffectsPositiveCopy, foundEffectsNegativeCopy, oldPostconditions, s);
             if (preconditionsValid) preconditionsValid = checkPreconditionValidityRigid(subtitutedRigidPreconditions, globalFreeArgRestrictions);
             if (preconditionsValid && _check_fluent_preconditions) {
@@ -2,60 +2,78 @@
 #include "retroactive_pruning.h"
 
 void RetroactivePruning::prune(const USignature& op, int layerIdx, int pos) {
+    prune(std::vector<USignature>(1, op), layerIdx, pos);
+}
+
+void RetroactivePruning::prune(const std::vector<USignature>& ops, int layerIdx, int pos) {
+
+    if (ops.empty()) return;
 
-    NodeHashSet<PositionedUSig, PositionedUSigHasher> opsToRemove;
-    NodeHashSet<PositionedUSig, PositionedUSigHasher> openOps;
-    openOps.emplace(layerIdx, pos, op);
+    std::vector<PositionedUSig> openOps;
+    FlatHashSet<PositionedUSig, PositionedUSigHasher> visitedUp;
+    for (const auto& op : ops) {
+        PositionedUSig psig(layerIdx, pos, op);
+        if (visitedUp.insert(psig).second) openOps.push_back(std::move(psig));
+    }
+    std::vector<PositionedUSig> opsToRemove;
+    FlatHashSet<PositionedUSig, PositionedUSigHasher> visitedDown;
     NodeHashMap<PositionedUSig, USigSet, PositionedUSigHasher> removedExpansionsOfParents;
 
+    auto markForRemoval = [&](PositionedUSig&& psig) {
+        if (visitedDown.insert(psig).second) opsToRemove.push_back(std::move(psig));
+    };
+
+    // Frozen positions are only thawed if they are actually modified
+    std::vector<Position*> thawedPositions;
+    auto beginModification = [&](Position& position) {
+        if (position.isFrozen()) {
+            thawedPositions.push_back(&position);
+            position.thaw();
+        }
+    };
+
     // Traverse the hierarchy upwards, removing expansions/predecessors
     // and marking all "root" operations whose induces subtrees should be pruned 
 
-    while (!openOps.empty()) {
-        PositionedUSig psig = *openOps.begin();
-        openOps.erase(psig);
+    for (size_t i = 0; i < openOps.size(); i++) {
+        PositionedUSig psig = openOps[i];
         Log::d("PRUNE_UP %s\n", TOSTR(psig));
 
         if (psig.layer == 0) {
             // Top of the hierarchy hit
-            opsToRemove.insert(psig);
+            markForRemoval(std::move(psig));
             continue;
         }
 
         Position& position = _layers[psig.layer]->at(psig.pos);
         assert(position.hasAction(psig.usig) || position.hasReduction(psig.usig));
-        int oldPos = 0;
-        Layer& oldLayer = *_layers.at(psig.layer-1);
-        while (oldPos+1 < (int)oldLayer.size() && oldLayer.getSuccessorPos(oldPos+1) <= psig.pos) 
-            oldPos++;
+        int oldPos = _layers.at(psig.layer-1)->getPredecessorPos(psig.pos);
 
         bool pruneSomeParent = false;
-        assert(position.getPredecessors().count(psig.usig) || Log::e("%s has no predecessors!\n", TOSTR(psig)));
-        for (const auto& parent : position.getPredecessors().at(psig.usig)) {
+        assert(position.hasPredecessors(psig.usig) || Log::e("%s has no predecessors!\n", TOSTR(psig)));
+        position.forEachPredecessor(psig.usig, [&](const USignature& parent) {
             PositionedUSig parentPSig(psig.layer-1, oldPos, parent);
-            //assert(oldLayer.at(oldPos).hasAction(parent) || oldLayer.at(oldPos).hasReduction(parent) || Log::e("%s\n", TOSTR(parentPSig)));
-            const auto& siblings = position.getExpansions().at(parent);
 
             // Mark op for removal from expansion of the parent
-            assert(siblings.count(psig.usig));
-            removedExpansionsOfParents[parentPSig].insert(psig.usig);
+            assert(position.hasExpansion(parent, psig.usig));
+            auto& removedExpansions = removedExpansionsOfParents[parentPSig];
+            removedExpansions.insert(psig.usig);
 
-            if (removedExpansionsOfParents[parentPSig].size() == siblings.size()) {
+            if (removedExpansions.size() == position.getNumExpansions(parent)) {
                 // Siblings become empty -> prune parent as well
-                openOps.insert(std::move(parentPSig));
+                if (visitedUp.insert(parentPSig).second) openOps.push_back(std::move(parentPSig));
                 pruneSomeParent = true;
             }
-        }
+        });
 
         // No parent pruned? -> This op is a root of a subtree to be pruned
-        if (!pruneSomeParent) opsToRemove.insert(psig);
+        if (!pruneSomeParent) markForRemoval(std::move(psig));
     }
 
     // Traverse the hierarchy downwards, pruning all children who became impossible
 
-    while (!opsToRemove.empty()) {
-        PositionedUSig psig = *opsToRemove.begin();
-        opsToRemove.erase(psig);
+    for (size_t i = 0; i < opsToRemove.size(); i++) {
+        PositionedUSig psig = opsToRemove[i];
         Position& position = _layers[psig.layer]->at(psig.pos);
         Log::d("PRUNE_DOWN %s\n", TOSTR(psig));
         assert(position.hasAction(psig.usig) || position.hasReduction(psig.usig));
@@ -66,19 +84,36 @@ void RetroactivePruning::prune(const USignature& op, int layerIdx, int pos) {
             while (belowPosIdx < (int)_layers.at(psig.layer)->getSuccessorPos(psig.pos+1)) {
 
                 Position& below = _layers.at(psig.layer+1)->at(belowPosIdx);
-                if (below.getExpansions().count(psig.usig)) for (auto& child : below.getExpansions().at(psig.usig)) {
-                    assert(below.getPredecessors().at(child).count(psig.usig));
-                    if (psig.layer+1 == (size_t)layerIdx && belowPosIdx == pos && child == op) {
-                        // Arrived back at original op to prune
-                        opsToRemove.emplace(layerIdx, pos, op);
-                    } else if (below.getPredecessors().at(child).size() == 1) {
+                if (below.getNumExpansions(psig.usig) == 0) 
+                    Log::d("PRUNE No expansions for %s @ (%i,%i)\n", TOSTR(psig), psig.layer+1, belowPosIdx);
+                
+                // (read on the frozen data if possible; modified only afterwards)
+                std::vector<USignature> childrenWithOtherPredecessors;
+                below.forEachExpansion(psig.usig, [&](const USignature& child) {
+                    PositionedUSig childPSig(psig.layer+1, belowPosIdx, child);
+                    if (visitedDown.count(childPSig)) {
+                        // Already marked for removal
+                        return;
+                    }
+                    size_t numPredecessors = below.getNumPredecessors(child);
+                    if (visitedUp.count(childPSig)) {
+                        // Arrived back at an op pruned on the way up
+                        markForRemoval(std::move(childPSig));
+                    } else if (numPredecessors == 1) {
                         // Child has this op as its only predecessor -> prune
-                        opsToRemove.emplace(psig.layer+1, belowPosIdx, child);
+                        markForRemoval(std::move(childPSig));
                     } else {
-                        Log::d("PRUNE %i pred left for %s@(%i,%i): %s\n", below.getPredecessors().at(child).size()-1, TOSTR(child), psig.layer+1, belowPosIdx);
+                        Log::d("PRUNE %i pred left for %s@(%i,%i): %s\n", numPredecessors-1, TOSTR(child), psig.layer+1, belowPosIdx);
+                        childrenWithOtherPredecessors.push_back(child);
+                    }
+                });
+                if (!childrenWithOtherPredecessors.empty()) {
+                    beginModification(below);
+                    for (const auto& child : childrenWithOtherPredecessors) {
+                        assert(below.getPredecessors().at(child).count(psig.usig));
                         below.getPredecessors().at(child).erase(psig.usig);
                     }
-                } else Log::d("PRUNE No expansions for %s @ (%i,%i)\n", TOSTR(psig), psig.layer+1, belowPosIdx);
+                }
 
                 belowPosIdx++;
             }
@@ -88,10 +123,14 @@ void RetroactivePruning::prune(const USignature& op, int layerIdx, int pos) {
         // together with its expansions and predecessors
         int opVar = position.getVariableOrZero(VarType::OP, psig.usig);
         if (opVar != 0) _enc.addUnitConstraint(-opVar);
+        beginModification(position);
         position.removeActionOccurrence(psig.usig);
         position.removeReductionOccurrence(psig.usig);
         _num_retroactively_pruned_ops++;
     }
 
-    _num_retroactive_prunings++;
+    // Restore the compact form of all positions which had to be thawed
+    for (Position* position : thawedPositions) position->freeze();
+
+    _num_retroactive_prunings += ops.size();
 }
@@ -21,6 +21,8 @@ public:
     RetroactivePruning(std::vector<Layer*>& layers, Encoding& enc) : _layers(layers), _enc(enc) {}
 
     void prune(const USignature& op, int layerIdx, int pos);
+    // Prunes all provided ops at the given position in a single traversal of the hierarchy.
+    void prune(const std::vector<USignature>& ops, int layerIdx, int pos);
 
     size_t getNumRetroactivePunings() const {return _num_retroactive_prunings;}
     size_t getNumRetroactivelyPrunedOps() const {return _num_retroactively_pruned_ops;}
@@ -0,0 +1,95 @@
+
+#include <algorithm>
+
+#include "algo/rigid_predicate_index.h"
+
+void RigidPredicateIndex::build(const USigSet& facts, const FlatHashSet<int>& excludedPredicates) {
+    _predicates.clear();
+
+    for (const auto& fact : facts) {
+        if (excludedPredicates.count(fact._name_id)) continue;
+        _predicates[fact._name_id].facts.push_back(fact._args);
+    }
+
+    for (auto& [predId, pred] : _predicates) {
+        std::sort(pred.facts.begin(), pred.facts.end());
+        size_t arity = pred.facts.front().size();
+        pred.positions.resize(arity);
+
+        for (size_t pos = 0; pos < arity; pos++) {
+            // Sort fact indices by the constant at this position
+            std::vector<std::pair<int, uint32_t>> entries(pred.facts.size());
+            for (uint32_t f = 0; f < pred.facts.size(); f++) entries[f] = {pred.facts[f][pos], f};
+            std::sort(entries.begin(), entries.end());
+
+            PositionIndex& idx = pred.positions[pos];
+            idx.factIds.resize(entries.size());
+            for (uint32_t i = 0; i < entries.size(); i++) {
+                idx.factIds[i] = entries[i].second;
+                auto it = idx.ranges.find(entries[i].first);
+                if (it == idx.ranges.end()) idx.ranges[entries[i].first] = {i, i+1};
+                else it->second.second = i+1;
+            }
+        }
+    }
+}
+
+bool RigidPredicateIndex::getPossibleConstants(int predId, size_t queriedPos, const std::vector<std::vector<int>>& eligibleArgs,
+        size_t limit, FlatHashSet<int>& result) const {
+
+    auto predIt = _predicates.find(predId);
+    if (predIt == _predicates.end()) return true;
+    const PredicateIndex& pred = predIt->second;
+    size_t arity = pred.positions.size();
+
+    // Find the bound position with the smallest number of matching facts
+    int bestPos = -1;
+    size_t bestSize = SIZE_MAX;
+    for (size_t pos = 0; pos < arity; pos++) {
+        if (pos == queriedPos) continue;
+        const auto& ranges = pred.positions[pos].ranges;
+        size_t size = 0;
+        for (int c : eligibleArgs[pos]) {
+            auto it = ranges.find(c);
+            if (it != ranges.end()) size += it->second.second - it->second.first;
+        }
+        if (size < bestSize) {
+            bestPos = pos;
+            bestSize = size;
+        }
+    }
+
+    std::vector<uint32_t> candidates;
+    if (bestPos < 0) {
+        // No bound positions: all facts match
+        candidates.resize(pred.facts.size());
+        for (uint32_t f = 0; f < candidates.size(); f++) candidates[f] = f;
+    } else {
+        // Union of the (disjoint) fact lists of each eligible constant
+        const PositionIndex& idx = pred.positions[bestPos];
+        candidates.reserve(bestSize);
+        for (int c : eligibleArgs[bestPos]) {
+            auto it = idx.ranges.find(c);
+            if (it == idx.ranges.end()) continue;
+            candidates.insert(candidates.end(), idx.factIds.begin()+it->second.first, idx.factIds.begin()+it->second.second);
+        }
+        std::sort(candidates.begin(), candidates.end());
+    }
+
+    // Intersect with the facts matching each other bound position
+    std::vector<int> sortedArgs;
+    for (size_t pos = 0; pos < arity && !candidates.empty(); pos++) {
+        if (pos == queriedPos || (int)pos == bestPos) continue;
+        sortedArgs = eligibleArgs[pos];
+        std::sort(sortedArgs.begin(), sortedArgs.end());
+        candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [&](uint32_t f) {
+            return !std::binary_search(sortedArgs.begin(), sortedArgs.end(), pred.facts[f][pos]);
+        }), candidates.end());
+    }
+
+    for (uint32_t f : candidates) {
+        result.insert(pred.facts[f][queriedPos]);
+        if (result.size() > limit) return false;
+    }
+    return true;
+}
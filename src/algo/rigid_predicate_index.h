@@ -0,0 +1,45 @@
+
+#ifndef DOMPASCH_LILOTANE_RIGID_PREDICATE_INDEX_H
+#define DOMPASCH_LILOTANE_RIGID_PREDICATE_INDEX_H
+
+#include <vector>
+#include <stdint.h>
+
+#include "data/signature.h"
+#include "util/hashmap.h"
+
+/*
+Index over the (initial, and hence final) ground facts of rigid predicates.
+For each predicate and argument position, the facts containing a certain constant
+at that position are stored as a sorted list of fact indices in CSR form.
+This allows to query "given these candidate arguments at the other positions,
+which constants are possible at position i" via sorted-list intersections.
+*/
+class RigidPredicateIndex {
+
+private:
+    struct PositionIndex {
+        // constant -> range [first, second) in factIds
+        FlatHashMap<int, std::pair<uint32_t, uint32_t>> ranges;
+        std::vector<uint32_t> factIds;
+    };
+    struct PredicateIndex {
+        std::vector<std::vector<int>> facts;
+        std::vector<PositionIndex> positions;
+    };
+    FlatHashMap<int, PredicateIndex> _predicates;
+
+public:
+    void build(const USigSet& facts, const FlatHashSet<int>& excludedPredicates);
+
+    bool hasPredicate(int predId) const {return _predicates.count(predId);}
+
+    // Collects all constants c such that there is a fact of the predicate
+    // with c at the queried position and with one of the eligible arguments
+    // at each other position (the entry of eligibleArgs at the queried position is ignored).
+    // Returns false if more than limit constants were found.
+    bool getPossibleConstants(int predId, size_t queriedPos, const std::vector<std::vector<int>>& eligibleArgs,
+            size_t limit, FlatHashSet<int>& result) const;
+};
+
+#endif
@@ -3,11 +3,9 @@
 
 Action::Action() : HtnOp() {}
 Action::Action(const HtnOp& op) : HtnOp(op) {}
-Action::Action(const Action& a) : HtnOp(a._id, a._args) {
-    _preconditions = a._preconditions;
-    _extra_preconditions = a._extra_preconditions;
-    _effects = a._effects;
-}
+Action::Action(HtnOp&& op) : HtnOp(std::move(op)) {}
+Action::Action(const Action& a) : HtnOp(a) {}
+Action::Action(Action&& a) : HtnOp(std::move(a)) {}
 Action::Action(int nameId, const std::vector<int>& args) : HtnOp(nameId, args) {}
 Action::Action(int nameId, std::vector<int>&& args) : HtnOp(nameId, std::move(args)) {}
 
@@ -18,4 +16,8 @@ Action& Action::operator=(const Action& op) {
     _extra_preconditions = op._extra_preconditions;
     _effects = op._effects;
     return *this;
+}
+Action& Action::operator=(Action&& op) {
+    HtnOp::operator=(std::move(op));
+    return *this;
 }
\ No newline at end of file
@@ -13,11 +13,14 @@ class Action : public HtnOp {
 public:
     Action();
     Action(const HtnOp& op);
+    Action(HtnOp&& op);
     Action(const Action& a);
+    Action(Action&& a);
     Action(int nameId, const std::vector<int>& args);
     Action(int nameId, std::vector<int>&& args);
 
     Action& operator=(const Action& op);
+    Action& operator=(Action&& op);
 };
 
 #endif
\ No newline at end of file
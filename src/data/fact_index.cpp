@@ -0,0 +1,83 @@
+
+#include "data/fact_index.h"
+#include "data/htn_instance.h"
+
+bool FactIndex::getDecodingIds(int predId, const std::vector<std::vector<int>>& eligibleArgs, std::vector<size_t>& ids) {
+    ids.clear();
+    if (eligibleArgs.empty()) return true;
+
+    const auto& layout = getLayout(predId);
+    if (!layout.indexable) return false;
+
+    // Contribution of each eligible argument to the ID of a decoding
+    std::vector<std::vector<size_t>> contributions(eligibleArgs.size());
+    size_t numDecodings = 1;
+    for (size_t i = 0; i < eligibleArgs.size(); i++) {
+        const auto& positions = getPositionsInSort(layout.sorts[i]);
+        contributions[i].reserve(eligibleArgs[i].size());
+        for (int arg : eligibleArgs[i]) {
+            auto it = positions.find(arg);
+            if (it == positions.end()) return false;
+            contributions[i].push_back(it->second * layout.strides[i]);
+        }
+        numDecodings *= eligibleArgs[i].size();
+    }
+
+    // Expand the cartesian product from the last to the first argument
+    // such that the first argument changes fastest
+    ids.reserve(numDecodings);
+    ids.push_back(layout.offset);
+    std::vector<size_t> expanded;
+    for (int i = eligibleArgs.size()-1; i >= 0; i--) {
+        const auto& contrib = contributions[i];
+        expanded.resize(ids.size() * contrib.size());
+        size_t x = 0;
+        for (size_t base : ids) {
+            for (size_t c : contrib) expanded[x++] = base + c;
+        }
+        ids.swap(expanded);
+    }
+    return true;
+}
+
+const FactIndex::PredicateLayout& FactIndex::getLayout(int predId) {
+    auto it = _layouts.find(predId);
+    if (it != _layouts.end()) return it->second;
+
+    PredicateLayout layout;
+    layout.sorts = _htn.getSorts(predId);
+    layout.strides.resize(layout.sorts.size());
+    size_t domainSize = 1;
+    bool fits = true;
+    for (size_t i = 0; i < layout.sorts.size(); i++) {
+        layout.strides[i] = domainSize;
+        size_t sortSize = getPositionsInSort(layout.sorts[i]).size();
+        if (sortSize > 0 && domainSize > MAX_PREDICATE_DOMAIN_SIZE / sortSize) {
+            fits = false;
+            break;
+        }
+        domainSize *= sortSize;
+    }
+    if (fits && _size + domainSize <= MAX_TOTAL_SIZE) {
+        layout.indexable = true;
+        layout.offset = _size;
+        _size += domainSize;
+    } else {
+        Log::d("Predicate %s is not indexed densely\n", TOSTR(predId));
+    }
+    return _layouts[predId] = std::move(layout);
+}
+
+const FlatHashMap<int, size_t>& FactIndex::getPositionsInSort(int sort) {
+    auto it = _positions_in_sort.find(sort);
+    if (it != _positions_in_sort.end()) return it->second;
+
+    std::vector<int> constants;
+    for (int c : _htn.getConstantsOfSort(sort)) {
+        if (!_htn.isQConstant(c)) constants.push_back(c);
+    }
+    std::sort(constants.begin(), constants.end());
+    auto& positions = _positions_in_sort[sort];
+    for (size_t i = 0; i < constants.size(); i++) positions[constants[i]] = i;
+    return positions;
+}
@@ -0,0 +1,173 @@
+
+#ifndef DOMPASCH_LILOTANE_FACT_INDEX_H
+#define DOMPASCH_LILOTANE_FACT_INDEX_H
+
+#include <vector>
+
+#include "data/signature.h"
+#include "util/hashmap.h"
+#include "util/bitset.h"
+
+class HtnInstance;
+
+/*
+Maps ground facts to dense integer IDs. Each predicate is assigned a contiguous
+range of IDs, and a fact's ID within the range is a mixed-radix number whose digits
+are the positions of its arguments within the respective sort domains of the predicate.
+Predicates with overly large domains (or arguments outside of the declared sorts)
+are not indexed; a negative ID is returned for such facts.
+*/
+class FactIndex {
+
+private:
+    HtnInstance& _htn;
+
+    struct PredicateLayout {
+        bool indexable = false;
+        size_t offset = 0;
+        std::vector<int> sorts;
+        std::vector<size_t> strides;
+    };
+    FlatHashMap<int, PredicateLayout> _layouts;
+    // sort -> constant -> position of constant within the sort's domain
+    NodeHashMap<int, FlatHashMap<int, size_t>> _positions_in_sort;
+
+    size_t _size = 0;
+
+public:
+    static const size_t MAX_PREDICATE_DOMAIN_SIZE = 1UL << 24;
+    static const size_t MAX_TOTAL_SIZE = 1UL << 27;
+
+    FactIndex(HtnInstance& htn) : _htn(htn) {}
+
+    inline long getId(const USignature& fact) {
+        const auto& layout = getLayout(fact._name_id);
+        if (!layout.indexable) return -1;
+        size_t id = layout.offset;
+        for (size_t i = 0; i < fact._args.size(); i++) {
+            const auto& positions = _positions_in_sort.at(layout.sorts[i]);
+            auto it = positions.find(fact._args[i]);
+            if (it == positions.end()) return -1;
+            id += it->second * layout.strides[i];
+        }
+        return id;
+    }
+
+    // Writes the IDs of all decodings of a fact with the given eligible arguments
+    // into ids, in the order of ArgIterator (first argument changing fastest).
+    // Returns false if some decoding cannot be indexed.
+    bool getDecodingIds(int predId, const std::vector<std::vector<int>>& eligibleArgs, std::vector<size_t>& ids);
+
+    size_t size() const {return _size;}
+
+private:
+    const PredicateLayout& getLayout(int predId);
+    const FlatHashMap<int, size_t>& getPositionsInSort(int sort);
+};
+
+/*
+A set of ground facts stored as a bitset over a FactIndex,
+with a hash set as fallback for facts which are not indexed.
+An order-independent (Zobrist) hash of the contained facts is maintained incrementally.
+*/
+class DenseFactSet {
+
+private:
+    FactIndex* _index;
+    Bitset _bits;
+    USigSet _fallback;
+    size_t _size = 0;
+    uint64_t _fingerprint = 0;
+
+    static inline uint64_t mix(uint64_t x) {
+        // splitmix64 finalizer
+        x += 0x9e3779b97f4a7c15ULL;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+    static inline uint64_t hashOfId(size_t id) {return mix(id);}
+    static inline uint64_t hashOfFallback(const USignature& fact) {
+        return mix(~(uint64_t)USignatureHasher()(fact));
+    }
+
+public:
+    DenseFactSet(FactIndex& index) : _index(&index) {}
+
+    inline bool insert(const USignature& fact) {
+        long id = _index->getId(fact);
+        if (id < 0) {
+            bool inserted = _fallback.insert(fact).second;
+            if (inserted) {
+                _size++;
+                _fingerprint ^= hashOfFallback(fact);
+            }
+            return inserted;
+        }
+        if (_bits.test(id)) return false;
+        _bits.grow(_index->size());
+        _bits.set(id);
+        _size++;
+        _fingerprint ^= hashOfId(id);
+        return true;
+    }
+    inline bool erase(const USignature& fact) {
+        long id = _index->getId(fact);
+        if (id < 0) {
+            bool erased = _fallback.erase(fact);
+            if (erased) {
+                _size--;
+                _fingerprint ^= hashOfFallback(fact);
+            }
+            return erased;
+        }
+        if (!_bits.test(id)) return false;
+        _bits.reset(id);
+        _size--;
+        _fingerprint ^= hashOfId(id);
+        return true;
+    }
+    inline bool contains(const USignature& fact) const {
+        long id = _index->getId(fact);
+        if (id < 0) return _fallback.count(fact);
+        return _bits.test(id);
+    }
+    inline size_t count(const USignature& fact) const {
+        return contains(fact) ? 1 : 0;
+    }
+    inline bool containsId(size_t id) const {
+        return _bits.test(id);
+    }
+    inline void insertId(size_t id) {
+        if (_bits.test(id)) return;
+        _bits.grow(_index->size());
+        _bits.set(id);
+        _size++;
+        _fingerprint ^= hashOfId(id);
+    }
+
+    // Overwrites this set with the contents of the other set,
+    // reusing the memory already allocated for the bitset.
+    inline void assign(const DenseFactSet& other) {
+        _bits.copyFrom(other._bits);
+        _fallback = other._fallback;
+        _size = other._size;
+        _fingerprint = other._fingerprint;
+    }
+
+    inline void clear() {
+        _bits.clear();
+        _fallback.clear();
+        _size = 0;
+        _fingerprint = 0;
+    }
+
+    inline size_t size() const {return _size;}
+    inline uint64_t getFingerprint() const {return _fingerprint;}
+    inline const Bitset& getBits() const {return _bits;}
+    inline size_t getMemoryUsage() const {
+        return _bits.getMemoryUsage() + _fallback.size() * sizeof(USignature);
+    }
+};
+
+#endif
@@ -0,0 +1,148 @@
+
+#ifndef DOMPASCH_LILOTANE_FROZEN_POSITION_H
+#define DOMPASCH_LILOTANE_FROZEN_POSITION_H
+
+#include <vector>
+#include <algorithm>
+#include <stdint.h>
+
+#include "data/signature.h"
+#include "util/hashmap.h"
+#include "util/spill_file.h"
+
+/*
+A list of signatures stored in a single flat array of ints ([name, args...] per signature).
+If constructed from a set, the signatures are sorted such that they can be found via binary search.
+*/
+class FlatSigList {
+
+private:
+    std::vector<int> _data;
+    std::vector<uint32_t> _offsets = std::vector<uint32_t>(1, 0);
+
+public:
+    inline void add(const USignature& sig) {
+        _data.push_back(sig._name_id);
+        _data.insert(_data.end(), sig._args.begin(), sig._args.end());
+        _offsets.push_back(_data.size());
+    }
+
+    inline size_t size() const {return _offsets.size()-1;}
+
+    inline USignature get(size_t i) const {
+        return USignature(_data[_offsets[i]], std::vector<int>(_data.begin()+_offsets[i]+1, _data.begin()+_offsets[i+1]));
+    }
+
+    // Three-way comparison of the i-th signature with the provided signature
+    inline int compare(size_t i, const USignature& sig) const {
+        const int* begin = _data.data() + _offsets[i];
+        const int* end = _data.data() + _offsets[i+1];
+        if (*begin != sig._name_id) return *begin < sig._name_id ? -1 : 1;
+        size_t len = end - begin - 1;
+        if (len != sig._args.size()) return len < sig._args.size() ? -1 : 1;
+        for (size_t a = 0; a < len; a++) {
+            if (begin[1+a] != sig._args[a]) return begin[1+a] < sig._args[a] ? -1 : 1;
+        }
+        return 0;
+    }
+
+    // Index of the provided signature in a sorted list, or -1 if not contained
+    inline long find(const USignature& sig) const {
+        size_t lo = 0, hi = size();
+        while (lo < hi) {
+            size_t mid = (lo + hi) / 2;
+            int cmp = compare(mid, sig);
+            if (cmp == 0) return mid;
+            if (cmp < 0) lo = mid+1;
+            else hi = mid;
+        }
+        return -1;
+    }
+
+    inline void shrink() {
+        _data.shrink_to_fit();
+        _offsets.shrink_to_fit();
+    }
+
+    inline size_t getMemoryUsage() const {
+        return _data.capacity() * sizeof(int) + _offsets.capacity() * sizeof(uint32_t);
+    }
+
+    inline void serialize(std::vector<uint8_t>& buf) const {
+        writeToBuffer(buf, _data);
+        writeToBuffer(buf, _offsets);
+    }
+    inline const uint8_t* deserialize(const uint8_t* buf) {
+        buf = readFromBuffer(buf, _data);
+        return readFromBuffer(buf, _offsets);
+    }
+
+    // Signatures of the provided collection in sorted order
+    template <typename Collection, typename Key>
+    static std::vector<const USignature*> sorted(const Collection& collection, Key key) {
+        std::vector<const USignature*> sigs;
+        sigs.reserve(collection.size());
+        for (const auto& elem : collection) sigs.push_back(&key(elem));
+        std::sort(sigs.begin(), sigs.end(), [](const USignature* a, const USignature* b) {
+            if (a->_name_id != b->_name_id) return a->_name_id < b->_name_id;
+            if (a->_args.size() != b->_args.size()) return a->_args.size() < b->_args.size();
+            return a->_args < b->_args;
+        });
+        return sigs;
+    }
+};
+
+/*
+Immutable compact form of the operations of a position whose layer has been fully encoded.
+*/
+struct FrozenPosition {
+
+    FlatSigList actions;
+    FlatSigList reductions;
+
+    // sorted op signatures and their variables
+    FlatSigList opSigs;
+    std::vector<int> opVars;
+
+    // parent -> children and child -> parents in CSR form
+    FlatSigList expansionParents;
+    std::vector<uint32_t> expansionOffsets;
+    FlatSigList expansionChildren;
+    FlatSigList predecessorChildren;
+    std::vector<uint32_t> predecessorOffsets;
+    FlatSigList predecessorParents;
+
+    inline int getOpVariableOrZero(const USignature& sig) const {
+        long idx = opSigs.find(sig);
+        return idx < 0 ? 0 : opVars[idx];
+    }
+
+    void serialize(std::vector<uint8_t>& buf) const {
+        for (const FlatSigList* list : {&actions, &reductions, &opSigs, &expansionParents, 
+                &expansionChildren, &predecessorChildren, &predecessorParents}) {
+            list->serialize(buf);
+        }
+        writeToBuffer(buf, opVars);
+        writeToBuffer(buf, expansionOffsets);
+        writeToBuffer(buf, predecessorOffsets);
+    }
+    void deserialize(const uint8_t* buf) {
+        for (FlatSigList* list : {&actions, &reductions, &opSigs, &expansionParents, 
+                &expansionChildren, &predecessorChildren, &predecessorParents}) {
+            buf = list->deserialize(buf);
+        }
+        buf = readFromBuffer(buf, opVars);
+        buf = readFromBuffer(buf, expansionOffsets);
+        readFromBuffer(buf, predecessorOffsets);
+    }
+
+    inline size_t getMemoryUsage() const {
+        return actions.getMemoryUsage() + reductions.getMemoryUsage() + opSigs.getMemoryUsage()
+            + opVars.capacity() * sizeof(int)
+            + expansionParents.getMemoryUsage() + expansionOffsets.capacity() * sizeof(uint32_t)
+            + expansionChildren.getMemoryUsage() + predecessorChildren.getMemoryUsage()
+            + predecessorOffsets.capacity() * sizeof(uint32_t) + predecessorParents.getMemoryUsage();
+    }
+};
+
+#endif
@@ -0,0 +1,43 @@
+
+#include <assert.h>
+
+#include "data/ground_op.h"
+
+GroundOp::GroundOp(const Action& a, const std::vector<int>& args) : 
+        _template(&a), _args(args), _s(a.getArguments(), args) {}
+GroundOp::GroundOp(const Reduction& r, const std::vector<int>& args) : 
+        _template(&r), _reduction_template(&r), _args(args), _s(r.getArguments(), args) {}
+
+USignature GroundOp::getTaskSignature() const {
+    assert(isReduction());
+    return _reduction_template->getTaskSignature().substitute(_s);
+}
+
+size_t GroundOp::getNumSubtasks() const {
+    assert(isReduction());
+    return _reduction_template->getSubtasks().size();
+}
+
+USignature GroundOp::getSubtask(size_t i) const {
+    assert(isReduction());
+    return _reduction_template->getSubtasks()[i].substitute(_s);
+}
+
+std::vector<USignature> GroundOp::getSubtasks() const {
+    assert(isReduction());
+    const auto& liftedSubtasks = _reduction_template->getSubtasks();
+    std::vector<USignature> subtasks;
+    subtasks.reserve(liftedSubtasks.size());
+    for (const USignature& subtask : liftedSubtasks) subtasks.push_back(subtask.substitute(_s));
+    return subtasks;
+}
+
+Action GroundOp::toAction() const {
+    assert(!isReduction());
+    return Action(_template->substitute(_s));
+}
+
+Reduction GroundOp::toReduction() const {
+    assert(isReduction());
+    return _reduction_template->substituteRed(_s);
+}
@@ -0,0 +1,54 @@
+
+#ifndef DOMPASCH_LILOTANE_GROUND_OP_H
+#define DOMPASCH_LILOTANE_GROUND_OP_H
+
+#include <vector>
+
+#include "data/action.h"
+#include "data/reduction.h"
+#include "data/substitution.h"
+
+/*
+View of an operator template instantiated with some arguments.
+Conditions, task and subtasks are substituted only when they are accessed,
+so inspecting a ground operation does not copy any of its sets.
+The template must outlive the view.
+*/
+class GroundOp {
+
+private:
+    const HtnOp* _template;
+    // Non-null if the template is a reduction
+    const Reduction* _reduction_template = nullptr;
+    std::vector<int> _args;
+    Substitution _s;
+
+public:
+    GroundOp(const Action& a, const std::vector<int>& args);
+    GroundOp(const Reduction& r, const std::vector<int>& args);
+
+    bool isReduction() const {return _reduction_template != nullptr;}
+    int getNameId() const {return _template->getNameId();}
+    const std::vector<int>& getArguments() const {return _args;}
+    USignature getSignature() const {return USignature(getNameId(), _args);}
+
+    template <typename F>
+    void forEachPrecondition(F f) const {
+        for (const Signature& pre : _template->getPreconditions()) f(pre.substitute(_s));
+    }
+    template <typename F>
+    void forEachEffect(F f) const {
+        for (const Signature& eff : _template->getEffects()) f(eff.substitute(_s));
+    }
+
+    // Only valid for reductions
+    USignature getTaskSignature() const;
+    size_t getNumSubtasks() const;
+    USignature getSubtask(size_t i) const;
+    std::vector<USignature> getSubtasks() const;
+
+    Action toAction() const;
+    Reduction toReduction() const;
+};
+
+#endif
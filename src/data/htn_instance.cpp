@@ -384,9 +384,9 @@ void HtnInstance::extractConstants() {
     for (const auto& sortPair : _p.sorts) {
         int sortId = nameId(sortPair.first);
         _constants_by_sort[sortId];
-        FlatHashSet<int>& constants = _constants_by_sort[sortId];
+        _constant_bitsets_by_sort[sortId];
         for (const std::string& c : sortPair.second) {
-            constants.insert(nameId(c));
+            addConstantToSort(sortId, nameId(c));
             //log("constant %s of sort %s\n", c.c_str(), sortPair.first.c_str());
         }
     }
@@ -670,30 +670,14 @@ int HtnInstance::getActionNameFromRepetition(int vChildId) const {
     return it == _repeated_to_actual_action.end() ? -1 : it->second;
 }
 
-Action HtnInstance::replaceVariablesWithQConstants(const Action& a, const std::vector<FlatHashSet<int>>& opArgDomains, int layerIdx, int pos) {
-    std::vector<int> newArgs = replaceVariablesWithQConstants((const HtnOp&)a, opArgDomains, layerIdx, pos);
-    if (newArgs.size() == 1 && newArgs[0] == -1) {
-        // No valid substitution.
-        return a;
-    }
-    return toAction(a.getNameId(), newArgs);
-}
-Reduction HtnInstance::replaceVariablesWithQConstants(const Reduction& red, const std::vector<FlatHashSet<int>>& opArgDomains, int layerIdx, int pos) {
-    std::vector<int> newArgs = replaceVariablesWithQConstants((const HtnOp&)red, opArgDomains, layerIdx, pos);
-    if (newArgs.size() == 1 && newArgs[0] == -1) {
-        // No valid substitution.
-        return red;
-    }
-    return red.substituteRed(Substitution(red.getArguments(), newArgs));
-}
-
-std::vector<int> HtnInstance::replaceVariablesWithQConstants(const HtnOp& op, 
+std::vector<int> HtnInstance::replaceVariablesWithQConstants(const USignature& opSig, 
             const std::vector<FlatHashSet<int>>& domainPerVariable, int layerIdx, int pos) {
     
-    if (op.getArguments().empty()) return std::vector<int>();
-    std::vector<int> vecFailure(1, -1);
+    if (opSig._args.empty()) return std::vector<int>();
+    // No valid substitution: keep the original arguments
+    const std::vector<int>& vecFailure = opSig._args;
 
-    std::vector<int> args = op.getArguments();
+    std::vector<int> args = opSig._args;
     std::vector<int> varargIndices;
     for (size_t i = 0; i < args.size(); i++) {
         const int& arg = args[i];
@@ -709,7 +693,7 @@ std::vector<int> HtnInstance::replaceVariablesWithQConstants(const HtnOp& op,
         auto& domain = domainPerVariable[i];
         if (domain.empty()) {
             // No valid constants at this position! The op is impossible.
-            Log::d("Empty domain for arg %s of %s\n", TOSTR(vararg), TOSTR(op.getSignature()));
+            Log::d("Empty domain for arg %s of %s\n", TOSTR(vararg), TOSTR(opSig));
             return vecFailure;
         }
         if (domain.size() == 1) {
@@ -721,7 +705,7 @@ std::vector<int> HtnInstance::replaceVariablesWithQConstants(const HtnOp& op,
 
             // Assemble name
             int sortCounter = 0;
-            int primarySort = _signature_sorts_table[op.getSignature()._name_id][i];
+            int primarySort = _signature_sorts_table[opSig._name_id][i];
             auto it = numIntroducedQConstsPerType.find(primarySort);
             if (it == numIntroducedQConstsPerType.end()) {
                 numIntroducedQConstsPerType[primarySort] = 1;
@@ -745,7 +729,7 @@ std::vector<int> HtnInstance::replaceVariablesWithQConstants(const HtnOp& op,
             assert(domain == getDomainOfQConstant(args[i]));
             assert(getOriginOfQConstant(args[i]) == IntPair(layerIdx, pos));
             /*
-            Log::d("QC %s : %s ~> %s ( ", TOSTR(op.getSignature()), TOSTR(vararg), TOSTR(args[i]), domain.size());
+            Log::d("QC %s : %s ~> %s ( ", TOSTR(opSig), TOSTR(vararg), TOSTR(args[i]), domain.size());
             for (int c : domain) {
                 Log::log_notime(Log::V4_DEBUG, "%s ", TOSTR(c));
             }
@@ -755,7 +739,7 @@ std::vector<int> HtnInstance::replaceVariablesWithQConstants(const HtnOp& op,
     }
 
     // Remember exact domain of each q constant for this operation
-    USignature newSig(op.getSignature()._name_id, args);
+    USignature newSig(opSig._name_id, args);
     for (auto& [qconst, domain] : domainsPerQConst) {
         _q_const_to_op_domains[qconst][newSig] = std::move(domain);
     }
@@ -763,31 +747,38 @@ std::vector<int> HtnInstance::replaceVariablesWithQConstants(const HtnOp& op,
     return args;
 }
 
+void HtnInstance::addConstantToSort(int sort, int constant) {
+    if (!_constants_by_sort[sort].insert(constant).second) return;
+    
+    // Assign a dense index to the constant if it is new
+    auto it = _constant_indices.find(constant);
+    int idx;
+    if (it == _constant_indices.end()) {
+        idx = _constants_by_index.size();
+        _constant_indices[constant] = idx;
+        _constants_by_index.push_back(constant);
+    } else idx = it->second;
+
+    Bitset& bitset = _constant_bitsets_by_sort[sort];
+    bitset.grow(idx+1);
+    bitset.set(idx);
+}
+
 void HtnInstance::initQConstantSorts(int id, const FlatHashSet<int>& domain) {
 
     // Create or retrieve the exact sort (= domain of constants) for this q-constant
     std::string qSortName = "qsort_" + _name_back_table[id];
     int newSortId = nameId(qSortName);
-    _constants_by_sort[newSortId].insert(domain.begin(), domain.end());
+    for (int c : domain) addConstantToSort(newSortId, c);
     _primary_sort_of_q_constants[id] = newSortId;
 
-    // CALCULATE ADDITIONAL SORTS OF Q CONSTANT
-
-    // 1. assume that the q-constant is of ALL (super) sorts
+    // CALCULATE ADDITIONAL SORTS OF Q CONSTANT:
+    // All (super) sorts which contain each constant of the primary sort
+    const Bitset& primaryDomain = _constant_bitsets_by_sort[newSortId];
     FlatHashSet<int> qConstSorts;
-    for (const auto& sortPair : _p.sorts) qConstSorts.insert(nameId(sortPair.first));
-
-    // 2. for each constant of the primary sort:
-    //      remove all q-constant sorts NOT containing that constant
-    for (int c : _constants_by_sort[newSortId]) {
-        std::vector<int> sortsToRemove;
-        for (int qsort : qConstSorts) {
-            if (std::find(_constants_by_sort[qsort].begin(), _constants_by_sort[qsort].end(), c) 
-                    == _constants_by_sort[qsort].end()) {
-                sortsToRemove.push_back(qsort);
-            }
-        }
-        for (int remSort : sortsToRemove) qConstSorts.erase(remSort);
+    for (const auto& sortPair : _p.sorts) {
+        int sort = nameId(sortPair.first);
+        if (primaryDomain.isSubsetOf(_constant_bitsets_by_sort[sort])) qConstSorts.insert(sort);
     }
     // RESULT: The intersection of sorts of all eligible constants.
     // => If the q-constant has some sort, it means that ALL possible substitutions have that sort.
@@ -810,15 +801,14 @@ std::vector<std::vector<int>> HtnInstance::getEligibleArgs(const USignature& qSi
         int arg = qSig._args[argPos];
         if (isVariable(arg) || isQConstant(arg)) {
             // Q-constant sort or variable
-            const auto& domain = _constants_by_sort.at(isQConstant(arg) ? _primary_sort_of_q_constants[arg] 
+            const Bitset& domain = getConstantBitsetOfSort(isQConstant(arg) ? _primary_sort_of_q_constants[arg] 
                         : getSorts(qSig._name_id).at(argPos));
             if (restrictiveSorts.empty()) {
-                eligibleArgs[argPos].insert(eligibleArgs[argPos].end(), domain.begin(), domain.end());
+                eligibleArgs[argPos] = getConstantsOfBitset(domain);
             } else {
-                const auto& restrictiveDomain = _constants_by_sort.at(restrictiveSorts.at(argPos));
-                for (int c : domain) {
-                    if (restrictiveDomain.count(c)) eligibleArgs[argPos].push_back(c);
-                }
+                Bitset restrictedDomain = domain;
+                restrictedDomain &= getConstantBitsetOfSort(restrictiveSorts.at(argPos));
+                eligibleArgs[argPos] = getConstantsOfBitset(restrictedDomain);
             }
         } else {
             // normal constant
@@ -849,6 +839,18 @@ const FlatHashSet<int>& HtnInstance::getConstantsOfSort(int sort) const {
     return _constants_by_sort.at(sort);
 }
 
+const Bitset EMPTY_BITSET;
+
+const Bitset& HtnInstance::getConstantBitsetOfSort(int sort) const {
+    auto it = _constant_bitsets_by_sort.find(sort);
+    if (it == _constant_bitsets_by_sort.end()) return EMPTY_BITSET;
+    return it->second;
+}
+
+const Bitset& HtnInstance::getDomainBitsetOfQConstant(int qconst) const {
+    return getConstantBitsetOfSort(_primary_sort_of_q_constants.at(qconst));
+}
+
 const FlatHashSet<int>& HtnInstance::getSortsOfQConstant(int qconst) {
     return _sorts_of_q_constants[qconst];
 }
@@ -908,6 +910,12 @@ Reduction HtnInstance::toReduction(int reductionName, const std::vector<int>& ar
     return op.substituteRed(Substitution(op.getArguments(), args));
 }
 
+GroundOp HtnInstance::toGroundOp(const USignature& opSig) const {
+    auto it = _methods.find(opSig._name_id);
+    if (it != _methods.end()) return GroundOp(it->second, opSig._args);
+    return GroundOp(_operators.at(opSig._name_id), opSig._args);
+}
+
 USignature HtnInstance::cutNonoriginalTaskArguments(const USignature& sig) {
     USignature sigCut(sig);
     sigCut._args.resize(_original_n_taskvars[sig._name_id]);
@@ -10,7 +10,9 @@
 #include "util/names.h"
 #include "util/params.h"
 #include "util/hashmap.h"
+#include "util/bitset.h"
 #include "data/op_table.h"
+#include "data/ground_op.h"
 
 #include "algo/arg_iterator.h"
 #include "algo/sample_arg_iterator.h"
@@ -53,6 +55,11 @@ private:
 
     // Maps a sort name ID to a set of constants of that sort.
     NodeHashMap<int, FlatHashSet<int>> _constants_by_sort;
+    // Maps a sort name ID to the set of dense indices of the constants of that sort.
+    NodeHashMap<int, Bitset> _constant_bitsets_by_sort;
+    // Maps a constant to its dense index, and vice versa.
+    FlatHashMap<int, int> _constant_indices;
+    std::vector<int> _constants_by_index;
 
     // Maps each q-constant to the sort it was created with.
     FlatHashMap<int, int> _primary_sort_of_q_constants;
@@ -113,6 +120,8 @@ public:
 
     Action toAction(int actionName, const std::vector<int>& args) const;
     Reduction toReduction(int reductionName, const std::vector<int>& args) const;
+    // Lazily substituted view of the action or reduction with the given signature
+    GroundOp toGroundOp(const USignature& opSig) const;
     HtnOp& getOp(const USignature& opSig);
     const Action& getActionTemplate(int nameId) const;
     const Reduction& getReductionTemplate(int nameId) const;
@@ -136,6 +145,22 @@ public:
     const FlatHashSet<int>& getSortsOfQConstant(int qconst);
     const IntPair& getOriginOfQConstant(int qconst) const;
     const FlatHashSet<int>& getDomainOfQConstant(int qconst) const;
+    const Bitset& getConstantBitsetOfSort(int sort) const;
+    const Bitset& getDomainBitsetOfQConstant(int qconst) const;
+    
+    inline int getConstantIndex(int c) const {
+        auto it = _constant_indices.find(c);
+        return it == _constant_indices.end() ? -1 : it->second;
+    }
+    inline int getConstantOfIndex(int idx) const {
+        return _constants_by_index[idx];
+    }
+    std::vector<int> getConstantsOfBitset(const Bitset& constants) const {
+        std::vector<int> result;
+        result.reserve(constants.count());
+        constants.forEach([&](size_t idx) {result.push_back(_constants_by_index[idx]);});
+        return result;
+    }
     std::vector<int> popOperationDependentDomainOfQConstant(int qconst, const USignature& op);
 
     std::vector<int> getOpSortsForCondition(const USignature& sig, const USignature& op);
@@ -144,8 +169,9 @@ public:
     ArgIterator decodeObjects(const USignature& qSig, std::vector<std::vector<int>> eligibleArgs);
     SampleArgIterator decodeObjects(const USignature& qSig, std::vector<std::vector<int>> eligibleArgs, size_t numSamples);
 
-    Action replaceVariablesWithQConstants(const Action& a, const std::vector<FlatHashSet<int>>& opArgDomains, int layerIdx, int pos);
-    Reduction replaceVariablesWithQConstants(const Reduction& red, const std::vector<FlatHashSet<int>>& opArgDomains, int layerIdx, int pos);
+    // Returns the op's arguments with each variable replaced by its only valid constant
+    // or by a new q-constant; returns the original arguments if some domain is empty.
+    std::vector<int> replaceVariablesWithQConstants(const USignature& opSig, const std::vector<FlatHashSet<int>>& opArgDomains, int layerIdx, int pos);
 
     USignature getNormalizedLifted(const USignature& opSig, std::vector<int>& placeholderArgs);
     std::vector<int> getAnonymousArglist(size_t size) {
@@ -278,16 +304,12 @@ public:
             if (isVariable(arg)) continue; // skip variable
             bool valid = false;
             if (isQConstant(arg)) {
-                // q constant: TODO check if SOME SUBSTITUTEABLE CONSTANT has the correct sort
-                for (int cnst : getDomainOfQConstant(arg)) {
-                    if (getConstantsOfSort(sort).count(cnst)) {
-                        valid = true;
-                        break;
-                    }
-                }
+                // q constant: check if SOME SUBSTITUTEABLE CONSTANT has the correct sort
+                valid = getDomainBitsetOfQConstant(arg).intersects(getConstantBitsetOfSort(sort));
             } else {
                 // normal constant: check if it is contained in the correct sort
-                valid = getConstantsOfSort(sort).count(arg);
+                int idx = getConstantIndex(arg);
+                valid = idx >= 0 && getConstantBitsetOfSort(sort).test(idx);
             }
             if (!valid) {
                 //log("arg %s not of sort %s => %s invalid\n", TOSTR(arg), TOSTR(sort), TOSTR(sig));
@@ -337,23 +359,22 @@ public:
             // Type is fine no matter which substitution is chosen
             if (getSortsOfQConstant(arg).count(sigSort)) continue;
 
-            // Type is NOT fine, at least for some substitutions
-            std::vector<int> good;
-            std::vector<int> bad;
-            const FlatHashSet<int>& validConstants = getConstantsOfSort(sigSort);
-            // For each value the qconstant can assume:
-            for (int c : getDomainOfQConstant(arg)) {
-                // Is that constant of correct type?
-                if (validConstants.count(c)) good.push_back(c);
-                else bad.push_back(c);
-            }
+            // Type is NOT fine, at least for some substitutions:
+            // Split the values the q-constant can assume by whether they are of correct type
+            const Bitset& domain = getDomainBitsetOfQConstant(arg);
+            Bitset good = domain;
+            good &= getConstantBitsetOfSort(sigSort);
+            size_t numGood = good.count();
+            size_t numBad = domain.count() - numGood;
 
-            if (good.size() >= bad.size()) {
+            if (numGood >= numBad) {
                 // arg must be EITHER of the GOOD ones
-                constraints.emplace_back(arg, true, std::move(good));
+                constraints.emplace_back(arg, true, getConstantsOfBitset(good));
             } else {
                 // arg must be NEITHER of the BAD ones
-                constraints.emplace_back(arg, false, std::move(bad));
+                Bitset bad = domain;
+                bad.subtract(good);
+                constraints.emplace_back(arg, false, getConstantsOfBitset(bad));
             }
         }
 
@@ -380,8 +401,8 @@ private:
     Reduction& createReduction(method& method);
     Action& createAction(const task& task);
 
-    std::vector<int> replaceVariablesWithQConstants(const HtnOp& op, const std::vector<FlatHashSet<int>>& opArgDomains, int layerIdx, int pos);
     void initQConstantSorts(int id, const FlatHashSet<int>& domain);
+    void addConstantToSort(int sort, int constant);
 
 };
 
@@ -64,6 +64,9 @@ HtnOp HtnOp::substitute(const Substitution& s) const {
         if (it != s.end()) op._args[i] = it->second;
         else op._args[i] = _args[i];
     }
+    op._preconditions.reserve(_preconditions.size());
+    op._extra_preconditions.reserve(_extra_preconditions.size());
+    op._effects.reserve(_effects.size());
     for (const Signature& sig : _preconditions) {
         op.addPrecondition(sig.substitute(s));
     }
@@ -102,4 +105,12 @@ HtnOp& HtnOp::operator=(const HtnOp& op) {
     _extra_preconditions = op._extra_preconditions;
     _effects = op._effects;
     return *this;
+}
+HtnOp& HtnOp::operator=(HtnOp&& op) {
+    _id = op._id;
+    _args = std::move(op._args);
+    _preconditions = std::move(op._preconditions);
+    _extra_preconditions = std::move(op._extra_preconditions);
+    _effects = std::move(op._effects);
+    return *this;
 }
\ No newline at end of file
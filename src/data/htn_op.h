@@ -51,6 +51,7 @@ public:
     int getNameId() const;
 
     HtnOp& operator=(const HtnOp& op);
+    HtnOp& operator=(HtnOp&& op);
 };
 
 
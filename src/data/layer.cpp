@@ -15,10 +15,17 @@ Position& Layer::at(size_t pos) {return (*this)[pos];}
 Position& Layer::last() {return (*this)[size()-1];}
 void Layer::consolidate() {
     int succ = 0;
+    _successor_positions.clear();
     for (size_t pos = 0; pos < size(); pos++) {
         _successor_positions.push_back(succ);
         succ += _content[pos].getMaxExpansionSize();
     }
+    _predecessor_positions.assign(getNextLayerSize(), 0);
+    for (size_t pos = 0; pos < size(); pos++) {
+        size_t end = pos+1 < size() ? _successor_positions[pos+1] : getNextLayerSize();
+        for (size_t newPos = _successor_positions[pos]; newPos < end; newPos++) 
+            _predecessor_positions[newPos] = pos;
+    }
 }
 size_t Layer::getNextLayerSize() const {
     return _successor_positions.back()+1;
@@ -27,10 +34,12 @@ size_t Layer::getSuccessorPos(size_t oldPos) const {
     assert(oldPos < _successor_positions.size());
     return _successor_positions[oldPos];
 }
+size_t Layer::getPredecessorPos(size_t newPos) const {
+    assert(newPos < _predecessor_positions.size());
+    return _predecessor_positions[newPos];
+}
 std::pair<size_t, size_t> Layer::getPredecessorPosAndOffset(size_t newPos) const {
-    size_t oldPos = 0;
-    while (oldPos+1 < size() && getSuccessorPos(oldPos+1) <= newPos) 
-        oldPos++;
+    size_t oldPos = getPredecessorPos(newPos);
     size_t offset = newPos - getSuccessorPos(oldPos);
     return std::pair<size_t, size_t>(oldPos, offset);
 }
@@ -13,6 +13,8 @@ private:
     size_t _index;
     std::vector<Position> _content;
     std::vector<size_t> _successor_positions;
+    // position at the next layer -> its parent position at this layer
+    std::vector<size_t> _predecessor_positions;
 
 public:
     Layer(size_t index, size_t size);
@@ -21,6 +23,7 @@ public:
     size_t index() const;
     size_t getNextLayerSize() const;
     size_t getSuccessorPos(size_t oldPos) const;
+    size_t getPredecessorPos(size_t newPos) const;
     std::pair<size_t, size_t> getPredecessorPosAndOffset(size_t thisPos) const;
     
     Position& at(size_t pos);
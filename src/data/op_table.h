@@ -19,10 +19,18 @@ public:
     void addAction(const Action& a) {
         _actions_by_sig[a.getSignature()] = a;
     }
+    void addAction(Action&& a) {
+        USignature sig = a.getSignature();
+        _actions_by_sig[std::move(sig)] = std::move(a);
+    }
     
     void addReduction(const Reduction& r) {
         _reductions_by_sig[r.getSignature()] = r;
     }
+    void addReduction(Reduction&& r) {
+        USignature sig = r.getSignature();
+        _reductions_by_sig[std::move(sig)] = std::move(r);
+    }
 
     bool hasAction(const USignature& sig) const {
         return _actions_by_sig.count(sig);
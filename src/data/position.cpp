@@ -6,37 +6,35 @@
 
 NodeHashMap<USignature, USigSet, USignatureHasher> Position::EMPTY_USIG_TO_USIG_SET_MAP;
 IndirectFactSupportMap Position::EMPTY_INDIRECT_FACT_SUPPORT_MAP;
+USigSet Position::EMPTY_USIG_SET;
+NodeHashMap<USignature, USigSubstitutionMap, USignatureHasher> Position::EMPTY_EXPANSION_SUBSTITUTIONS;
+NodeHashMap<USignature, std::vector<TypeConstraint>, USignatureHasher> Position::EMPTY_TYPE_CONSTRAINTS;
 
 Position::Position() : _layer_idx(-1), _pos(-1) {}
 void Position::setPos(size_t layerIdx, size_t pos) {_layer_idx = layerIdx; _pos = pos;}
 
 void Position::addQFact(const USignature& qfact) {
-    _qfacts.insert(qfact);
+    instData().qfacts.insert(qfact);
 }
-void Position::addTrueFact(const USignature& fact) {_true_facts.insert(fact);}
-void Position::addFalseFact(const USignature& fact) {_false_facts.insert(fact);}
-void Position::addDefinitiveFact(const Signature& fact) {(fact._negated ? _false_facts : _true_facts).insert(fact._usig);}
+void Position::addTrueFact(const USignature& fact) {factData().true_facts.insert(fact);}
+void Position::addFalseFact(const USignature& fact) {factData().false_facts.insert(fact);}
+void Position::addDefinitiveFact(const Signature& fact) {(fact._negated ? factData().false_facts : factData().true_facts).insert(fact._usig);}
 
 void Position::addFactSupport(const Signature& fact, const USignature& operation) {
-    auto& supp = fact._negated ? _neg_fact_supports : _pos_fact_supports;
-    if (supp == nullptr) supp = new NodeHashMap<USignature, USigSet, USignatureHasher>();
-    auto& set = (*supp)[fact._usig];
+    auto& supp = fact._negated ? instData().neg_fact_supports : instData().pos_fact_supports;
+    auto& set = supp[fact._usig];
     set.insert(operation);
 }
 void Position::touchFactSupport(const Signature& fact) {
-    auto& supp = fact._negated ? _neg_fact_supports : _pos_fact_supports;
-    if (supp == nullptr) supp = new NodeHashMap<USignature, USigSet, USignatureHasher>();
-    (*supp)[fact._usig];
+    touchFactSupport(fact._usig, fact._negated);
 }
 void Position::touchFactSupport(const USignature& fact, bool negated) {
-    auto& supp = negated ? _neg_fact_supports : _pos_fact_supports;
-    if (supp == nullptr) supp = new NodeHashMap<USignature, USigSet, USignatureHasher>();
-    (*supp)[fact];
+    auto& supp = negated ? instData().neg_fact_supports : instData().pos_fact_supports;
+    supp[fact];
 }
 void Position::addIndirectFactSupport(const USignature& fact, bool negated, const USignature& op, const std::vector<IntPair>& path) {
-    auto& supp = negated ? _neg_indir_fact_supports : _pos_indir_fact_supports;
-    if (supp == nullptr) supp = new IndirectFactSupportMap();
-    auto& tree = (*supp)[fact][op];
+    auto& supp = negated ? instData().neg_indir_fact_supports : instData().pos_indir_fact_supports;
+    auto& tree = supp[fact][op];
     tree.insert(path);
 }
 void Position::setHasPrimitiveOps(bool has) {
@@ -53,66 +51,72 @@ bool Position::hasNonprimitiveOps() {
 }
 
 void Position::addQConstantTypeConstraint(const USignature& op, const TypeConstraint& c) {
-    auto& vec = _q_constants_type_constraints[op];
+    auto& vec = instData().q_constants_type_constraints[op];
     vec.push_back(c);
 }
 
 void Position::addSubstitutionConstraint(const USignature& op, SubstitutionConstraint&& constr) {
-    _substitution_constraints[op].emplace_back(std::move(constr));
+    instData().substitution_constraints[op].add(std::move(constr));
 }
 
 void Position::addQFactDecoding(const USignature& qFact, const USignature& decFact, bool negated) {
-    auto& set = negated ? _neg_qfact_decodings : _pos_qfact_decodings;
+    auto& set = negated ? factData().neg_qfact_decodings : factData().pos_qfact_decodings;
     set[qFact].insert(decFact);
     //Log::v("QFACTDEC %s -> %s (%s)\n", TOSTR(qFact), TOSTR(decFact), negated?"false":"true");
 }
 
 void Position::removeQFactDecoding(const USignature& qFact, const USignature& decFact, bool negated) {
-    auto& set = negated ? _neg_qfact_decodings : _pos_qfact_decodings;
+    auto& set = negated ? factData().neg_qfact_decodings : factData().pos_qfact_decodings;
     set[qFact].erase(decFact);
 }
 
 bool Position::hasQFactDecodings(const USignature& qFact, bool negated) {
-    auto& set = negated ? _neg_qfact_decodings : _pos_qfact_decodings;
+    if (!_fact_data) return false;
+    auto& set = negated ? _fact_data->neg_qfact_decodings : _fact_data->pos_qfact_decodings;
     return set.count(qFact);
 }
 
 const USigSet& Position::getQFactDecodings(const USignature& qFact, bool negated) {
-    auto& set = negated ? _neg_qfact_decodings : _pos_qfact_decodings;
+    auto& set = negated ? factData().neg_qfact_decodings : factData().pos_qfact_decodings;
     assert(set.count(qFact) || Log::e("No qfact decodings for %s!\n", TOSTR(qFact)));
     return set.at(qFact);
 }
 
 void Position::addAction(const USignature& action) {
+    if (isFrozen()) thaw();
     _actions.insert(action);
     Log::d("+ACTION@(%i,%i) %s\n", _layer_idx, _pos, TOSTR(action));
 }
 void Position::addAction(USignature&& action) {
+    if (isFrozen()) thaw();
     Log::d("+ACTION@(%i,%i) %s\n", _layer_idx, _pos, TOSTR(action));
     _actions.insert(std::move(action));
 }
 void Position::addReduction(const USignature& reduction) {
+    if (isFrozen()) thaw();
     _reductions.insert(reduction);
     Log::d("+REDUCTION@(%i,%i) %s\n", _layer_idx, _pos, TOSTR(reduction));
 }
 void Position::addExpansion(const USignature& parent, const USignature& child) {
+    if (isFrozen()) thaw();
     auto& set = _expansions[parent];
     set.insert(child);
     auto& pred = _predecessors[child];
     pred.insert(parent);
 }
 void Position::addExpansionSubstitution(const USignature& parent, const USignature& child, Substitution&& s) {
-    _expansion_substitutions[parent][child] = std::move(s);
+    instData().expansion_substitutions[parent][child] = std::move(s);
 }
 void Position::addExpansionSubstitution(const USignature& parent, const USignature& child, const Substitution& s) {
-    _expansion_substitutions[parent][child] = s;
+    instData().expansion_substitutions[parent][child] = s;
 }
 void Position::addAxiomaticOp(const USignature& op) {
-    _axiomatic_ops.insert(op);
+    instData().axiomatic_ops.insert(op);
 }
 void Position::addExpansionSize(size_t size) {_max_expansion_size = std::max(_max_expansion_size, size);}
 
 void Position::removeActionOccurrence(const USignature& action) {
+    if (isFrozen()) thaw();
     _actions.erase(action);
     for (auto& [parent, children] : _expansions) {
         children.erase(action);
@@ -120,6 +124,7 @@ void Position::removeActionOccurrence(const USignature& action) {
     _predecessors.erase(action);
 }
 void Position::removeReductionOccurrence(const USignature& reduction) {
+    if (isFrozen()) thaw();
     _reductions.erase(reduction);
     for (auto& [parent, children] : _expansions) {
         children.erase(reduction);
@@ -137,9 +142,15 @@ void Position::replaceOperation(const USignature& from, const USignature& to, Su
 }
 
 const NodeHashMap<USignature, int, USignatureHasher>& Position::getVariableTable(VarType type) const {
+    if (type == OP && isFrozen()) {
+        // The op variables of a frozen position only exist in compact form (see forEachOpVariable)
+        Log::e("Op variable table of frozen position (%i,%i) queried!\n", _layer_idx, _pos);
+        exit(1);
+    }
     return type == OP ? _op_variables : _fact_variables;
 }
 void Position::setVariableTable(VarType type, const NodeHashMap<USignature, int, USignatureHasher>& table) {
+    if (isFrozen()) thaw();
     if (type == OP) {
         _op_variables = table;
     } else {
@@ -147,6 +158,8 @@ void Position::setVariableTable(VarType type, const NodeHashMap<USignature, int,
     }
 }
 void Position::moveVariableTable(VarType type, Position& destination) {
+    if (isFrozen()) thaw();
+    if (destination.isFrozen()) destination.thaw();
     auto& src = type == OP ? _op_variables : _fact_variables;
     auto& dest = type == OP ? destination._op_variables : destination._fact_variables;
     dest = std::move(src);
@@ -154,78 +167,114 @@ void Position::moveVariableTable(VarType type, Position& destination) {
     src.reserve(0);
 }
 
-bool Position::hasQFact(const USignature& fact) const {return _qfacts.count(fact);}
-bool Position::hasAction(const USignature& action) const {return _actions.count(action);}
-bool Position::hasReduction(const USignature& red) const {return _reductions.count(red);}
+bool Position::hasQFact(const USignature& fact) const {return _inst_data && _inst_data->qfacts.count(fact);}
+bool Position::hasAction(const USignature& action) const {
+    if (isFrozen()) return getFrozen().actions.find(action) >= 0;
+    return _actions.count(action);
+}
+bool Position::hasReduction(const USignature& red) const {
+    if (isFrozen()) return getFrozen().reductions.find(red) >= 0;
+    return _reductions.count(red);
+}
 
 size_t Position::getLayerIndex() const {return _layer_idx;}
 size_t Position::getPositionIndex() const {return _pos;}
 
-const USigSet& Position::getQFacts() const {return _qfacts;}
-const USigSet& Position::getTrueFacts() const {return _true_facts;}
-const USigSet& Position::getFalseFacts() const {return _false_facts;}
+const USigSet& Position::getQFacts() const {return _inst_data ? _inst_data->qfacts : EMPTY_USIG_SET;}
+int Position::getNumQFacts() const {return getQFacts().size();}
+const USigSet& Position::getTrueFacts() const {return _fact_data ? _fact_data->true_facts : EMPTY_USIG_SET;}
+const USigSet& Position::getFalseFacts() const {return _fact_data ? _fact_data->false_facts : EMPTY_USIG_SET;}
 NodeHashMap<USignature, USigSet, USignatureHasher>& Position::getPosFactSupports() {
-    if (_pos_fact_supports == nullptr) return EMPTY_USIG_TO_USIG_SET_MAP;
-    return *_pos_fact_supports;
+    if (!_inst_data) return EMPTY_USIG_TO_USIG_SET_MAP;
+    return _inst_data->pos_fact_supports;
 }
 NodeHashMap<USignature, USigSet, USignatureHasher>& Position::getNegFactSupports() {
-    if (_neg_fact_supports == nullptr) return EMPTY_USIG_TO_USIG_SET_MAP;
-    return *_neg_fact_supports;
+    if (!_inst_data) return EMPTY_USIG_TO_USIG_SET_MAP;
+    return _inst_data->neg_fact_supports;
 }
 IndirectFactSupportMap& Position::getPosIndirectFactSupports() {
-    if (_pos_indir_fact_supports == nullptr) return EMPTY_INDIRECT_FACT_SUPPORT_MAP;
-    return *_pos_indir_fact_supports;
+    if (!_inst_data) return EMPTY_INDIRECT_FACT_SUPPORT_MAP;
+    return _inst_data->pos_indir_fact_supports;
 }
 IndirectFactSupportMap& Position::getNegIndirectFactSupports() {
-    if (_neg_indir_fact_supports == nullptr) return EMPTY_INDIRECT_FACT_SUPPORT_MAP;
-    return *_neg_indir_fact_supports;
+    if (!_inst_data) return EMPTY_INDIRECT_FACT_SUPPORT_MAP;
+    return _inst_data->neg_indir_fact_supports;
 }
 const NodeHashMap<USignature, std::vector<TypeConstraint>, USignatureHasher>& Position::getQConstantsTypeConstraints() const {
-    return _q_constants_type_constraints;
+    return _inst_data ? _inst_data->q_constants_type_constraints : EMPTY_TYPE_CONSTRAINTS;
 }
 
-USigSet& Position::getActions() {return _actions;}
-const USigSet& Position::getReductions() const {return _reductions;}
-NodeHashMap<USignature, USigSet, USignatureHasher>& Position::getExpansions() {return _expansions;}
-NodeHashMap<USignature, USigSet, USignatureHasher>& Position::getPredecessors() {return _predecessors;}
-const NodeHashMap<USignature, USigSubstitutionMap, USignatureHasher>& Position::getExpansionSubstitutions() const {return _expansion_substitutions;}
-const USigSet& Position::getAxiomaticOps() const {return _axiomatic_ops;}
-size_t Position::getMaxExpansionSize() const {return _max_expansion_size;}
+USigSet& Position::getActions() {
+    if (isFrozen()) thaw();
+    return _actions;
+}
+USigSet& Position::getReductions() {
+    if (isFrozen()) thaw();
+    return _reductions;
+}
+NodeHashMap<USignature, USigSet, USignatureHasher>& Position::getExpansions() {
+    if (isFrozen()) thaw();
+    return _expansions;
+}
+NodeHashMap<USignature, USigSet, USignatureHasher>& Position::getPredecessors() {
+    if (isFrozen()) thaw();
+    return _predecessors;
+}
+bool Position::hasPredecessors(const USignature& child) const {
+    if (isFrozen()) return getFrozen().predecessorChildren.find(child) >= 0;
+    return _predecessors.count(child);
+}
+size_t Position::getNumPredecessors(const USignature& child) const {
+    if (isFrozen()) {
+        const FrozenPosition& f = getFrozen();
+        long i = f.predecessorChildren.find(child);
+        return i < 0 ? 0 : f.predecessorOffsets[i+1] - f.predecessorOffsets[i];
+    }
+    auto it = _predecessors.find(child);
+    return it == _predecessors.end() ? 0 : it->second.size();
+}
+size_t Position::getNumExpansions(const USignature& parent) const {
+    if (isFrozen()) {
+        const FrozenPosition& f = getFrozen();
+        long i = f.expansionParents.find(parent);
+        return i < 0 ? 0 : f.expansionOffsets[i+1] - f.expansionOffsets[i];
+    }
+    auto it = _expansions.find(parent);
+    return it == _expansions.end() ? 0 : it->second.size();
+}
+bool Position::hasExpansion(const USignature& parent, const USignature& child) const {
+    if (isFrozen()) {
+        const FrozenPosition& f = getFrozen();
+        long i = f.expansionParents.find(parent);
+        if (i < 0) return false;
+        for (size_t j = f.expansionOffsets[i]; j < f.expansionOffsets[i+1]; j++) 
+            if (f.expansionChildren.compare(j, child) == 0) return true;
+        return false;
+    }
+    auto it = _expansions.find(parent);
+    return it != _expansions.end() && it->second.count(child);
+}
+const NodeHashMap<USignature, USigSubstitutionMap, USignatureHasher>& Position::getExpansionSubstitutions() const {
+    return _inst_data ? _inst_data->expansion_substitutions : EMPTY_EXPANSION_SUBSTITUTIONS;
+}
+const USigSet& Position::getAxiomaticOps() const {return _inst_data ? _inst_data->axiomatic_ops : EMPTY_USIG_SET;}
+size_t Position::getMaxExpansionSize() const {return _deferred ? 1 : _max_expansion_size;}
 
 void Position::clearAfterInstantiation() {
 }
 
 void Position::clearAtPastPosition() {
-    _qfacts.clear();
-    _qfacts.reserve(0);
     /*
     _expansions.clear();
     _expansions.reserve(0);
     _predecessors.clear();
     _predecessors.reserve(0);
     */
-   _expansion_substitutions.clear();
-   _expansion_substitutions.reserve(0);
-    _axiomatic_ops.clear();
-    _axiomatic_ops.reserve(0);
-    _q_constants_type_constraints.clear();
-    _q_constants_type_constraints.reserve(0);
-    clearSubstitutions();
-    if (_pos_fact_supports != nullptr) delete _pos_fact_supports;
-    if (_neg_fact_supports != nullptr) delete _neg_fact_supports;
-    if (_pos_indir_fact_supports != nullptr) delete _pos_indir_fact_supports;
-    if (_neg_indir_fact_supports != nullptr) delete _neg_indir_fact_supports;
+    _inst_data.reset();
 }
 
 void Position::clearAtPastLayer() {
-    _pos_qfact_decodings.clear();
-    _pos_qfact_decodings.reserve(0);
-    _neg_qfact_decodings.clear();
-    _neg_qfact_decodings.reserve(0);
-    _true_facts.clear();
-    _true_facts.reserve(0);
-    _false_facts.clear();
-    _false_facts.reserve(0);
+    _fact_data.reset();
     _fact_variables.clear();
     _fact_variables.reserve(0);
     /*
@@ -234,4 +283,96 @@ void Position::clearAtPastLayer() {
     _reductions.clear();
     _reductions.reserve(0);
     */
-}
\ No newline at end of file
+}
+
+void Position::freeze() {
+    if (isFrozen()) return;
+    _frozen.reset(new FrozenPosition());
+    FrozenPosition& f = *_frozen;
+    auto identity = [](const USignature& sig) -> const USignature& {return sig;};
+    auto key = [](const auto& entry) -> const USignature& {return entry.first;};
+
+    for (const USignature* sig : FlatSigList::sorted(_actions, identity)) f.actions.add(*sig);
+    for (const USignature* sig : FlatSigList::sorted(_reductions, identity)) f.reductions.add(*sig);
+    for (const USignature* sig : FlatSigList::sorted(_op_variables, key)) {
+        f.opSigs.add(*sig);
+        f.opVars.push_back(_op_variables.at(*sig));
+    }
+    f.expansionOffsets.push_back(0);
+    for (const USignature* parent : FlatSigList::sorted(_expansions, key)) {
+        f.expansionParents.add(*parent);
+        for (const USignature* child : FlatSigList::sorted(_expansions.at(*parent), identity)) 
+            f.expansionChildren.add(*child);
+        f.expansionOffsets.push_back(f.expansionChildren.size());
+    }
+    f.predecessorOffsets.push_back(0);
+    for (const USignature* child : FlatSigList::sorted(_predecessors, key)) {
+        f.predecessorChildren.add(*child);
+        for (const USignature* parent : FlatSigList::sorted(_predecessors.at(*child), identity)) 
+            f.predecessorParents.add(*parent);
+        f.predecessorOffsets.push_back(f.predecessorParents.size());
+    }
+    for (FlatSigList* list : {&f.actions, &f.reductions, &f.opSigs, &f.expansionParents, 
+            &f.expansionChildren, &f.predecessorChildren, &f.predecessorParents}) {
+        list->shrink();
+    }
+    f.opVars.shrink_to_fit();
+
+    _actions = USigSet();
+    _reductions = USigSet();
+    _op_variables = NodeHashMap<USignature, int, USignatureHasher>();
+    _expansions = NodeHashMap<USignature, USigSet, USignatureHasher>();
+    _predecessors = NodeHashMap<USignature, USigSet, USignatureHasher>();
+}
+
+void Position::thaw() {
+    if (!isFrozen()) return;
+    Log::d("Thawing position (%i,%i)\n", _layer_idx, _pos);
+    if (_spilled) pageIn();
+    _frozen_is_spilled = false;
+    std::unique_ptr<FrozenPosition> frozen = std::move(_frozen);
+    FrozenPosition& f = *frozen;
+
+    for (size_t i = 0; i < f.actions.size(); i++) _actions.insert(f.actions.get(i));
+    for (size_t i = 0; i < f.reductions.size(); i++) _reductions.insert(f.reductions.get(i));
+    for (size_t i = 0; i < f.opSigs.size(); i++) _op_variables[f.opSigs.get(i)] = f.opVars[i];
+    for (size_t i = 0; i < f.expansionParents.size(); i++) {
+        auto& children = _expansions[f.expansionParents.get(i)];
+        for (size_t j = f.expansionOffsets[i]; j < f.expansionOffsets[i+1]; j++) 
+            children.insert(f.expansionChildren.get(j));
+    }
+    for (size_t i = 0; i < f.predecessorChildren.size(); i++) {
+        auto& parents = _predecessors[f.predecessorChildren.get(i)];
+        for (size_t j = f.predecessorOffsets[i]; j < f.predecessorOffsets[i+1]; j++) 
+            parents.insert(f.predecessorParents.get(j));
+    }
+}
+
+void Position::spill(SpillFile& file) {
+    if (_spilled) return;
+    if (!_frozen) freeze();
+    bool contained = _frozen_is_spilled && _spill_offset >= 0 && _spill_file == &file;
+    if (!contained) {
+        // Frozen data may not be contained in the file yet:
+        // only write it if it differs from the spilled copy
+        std::vector<uint8_t> buf;
+        _frozen->serialize(buf);
+        bool unchanged = _spill_offset >= 0 && _spill_file == &file && _spill_size == buf.size()
+            && std::equal(buf.begin(), buf.end(), file.map(_spill_offset, _spill_size));
+        if (!unchanged) {
+            _spill_file = &file;
+            _spill_offset = file.append(buf);
+            _spill_size = buf.size();
+        }
+    }
+    _frozen.reset();
+    _spilled = true;
+}
+
+void Position::pageIn() const {
+    Log::d("Paging in position (%i,%i)\n", _layer_idx, _pos);
+    _frozen.reset(new FrozenPosition());
+    _frozen->deserialize(_spill_file->map(_spill_offset, _spill_size));
+    _spilled = false;
+    _frozen_is_spilled = true;
+}
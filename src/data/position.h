@@ -4,6 +4,7 @@
 
 #include <vector>
 #include <set>
+#include <memory>
 
 #include "util/hashmap.h"
 #include "data/signature.h"
@@ -11,7 +12,8 @@
 #include "sat/variable_domain.h"
 #include "util/log.h"
 #include "sat/literal_tree.h"
-#include "data/substitution_constraint.h"
+#include "data/substitution_constraint_index.h"
+#include "data/frozen_position.h"
 
 typedef NodeHashMap<USignature, IntPairTree, USignatureHasher> IndirectFactSupportMapEntry;
 typedef NodeHashMap<USignature, IndirectFactSupportMapEntry, USignatureHasher> IndirectFactSupportMap;
@@ -24,8 +26,42 @@ struct Position {
 public:
     static NodeHashMap<USignature, USigSet, USignatureHasher> EMPTY_USIG_TO_USIG_SET_MAP;
     static IndirectFactSupportMap EMPTY_INDIRECT_FACT_SUPPORT_MAP;
+    static USigSet EMPTY_USIG_SET;
+    static NodeHashMap<USignature, USigSubstitutionMap, USignatureHasher> EMPTY_EXPANSION_SUBSTITUTIONS;
+    static NodeHashMap<USignature, std::vector<TypeConstraint>, USignatureHasher> EMPTY_TYPE_CONSTRAINTS;
 
 private:
+    // Data which is only needed while the position and its neighbors are being 
+    // instantiated and encoded. Allocated on first use, dropped by clearAtPastPosition().
+    struct InstantiationData {
+        NodeHashMap<USignature, USigSubstitutionMap, USignatureHasher> expansion_substitutions;
+
+        USigSet axiomatic_ops;
+
+        // All VIRTUAL facts potentially occurring at this position.
+        USigSet qfacts;
+
+        NodeHashMap<USignature, USigSet, USignatureHasher> pos_fact_supports;
+        NodeHashMap<USignature, USigSet, USignatureHasher> neg_fact_supports;
+        IndirectFactSupportMap pos_indir_fact_supports;
+        IndirectFactSupportMap neg_indir_fact_supports;
+
+        NodeHashMap<USignature, std::vector<TypeConstraint>, USignatureHasher> q_constants_type_constraints;
+        NodeHashMap<USignature, SubstitutionConstraintIndex, USignatureHasher> substitution_constraints;
+    };
+    // Facts which are needed while the layer is being encoded.
+    // Allocated on first use, dropped by clearAtPastLayer().
+    struct FactData {
+        // Maps a q-fact to the set of possibly valid decoded facts.
+        NodeHashMap<USignature, USigSet, USignatureHasher> pos_qfact_decodings;
+        NodeHashMap<USignature, USigSet, USignatureHasher> neg_qfact_decodings;
+
+        // All facts that are definitely true at this position.
+        USigSet true_facts;
+        // All facts that are definitely false at this position.
+        USigSet false_facts;
+    };
+
     size_t _layer_idx;
     size_t _pos;
 
@@ -34,28 +70,21 @@ private:
 
     NodeHashMap<USignature, USigSet, USignatureHasher> _expansions;
     NodeHashMap<USignature, USigSet, USignatureHasher> _predecessors;
-    NodeHashMap<USignature, USigSubstitutionMap, USignatureHasher> _expansion_substitutions;
-
-    USigSet _axiomatic_ops;
-
-    // All VIRTUAL facts potentially occurring at this position.
-    USigSet _qfacts;
-    // Maps a q-fact to the set of possibly valid decoded facts.
-    NodeHashMap<USignature, USigSet, USignatureHasher> _pos_qfact_decodings;
-    NodeHashMap<USignature, USigSet, USignatureHasher> _neg_qfact_decodings;
-
-    // All facts that are definitely true at this position.
-    USigSet _true_facts;
-    // All facts that are definitely false at this position.
-    USigSet _false_facts;
-
-    NodeHashMap<USignature, USigSet, USignatureHasher>* _pos_fact_supports = nullptr;
-    NodeHashMap<USignature, USigSet, USignatureHasher>* _neg_fact_supports = nullptr;
-    IndirectFactSupportMap* _pos_indir_fact_supports = nullptr;
-    IndirectFactSupportMap* _neg_indir_fact_supports = nullptr;
 
-    NodeHashMap<USignature, std::vector<TypeConstraint>, USignatureHasher> _q_constants_type_constraints;
-    NodeHashMap<USignature, std::vector<SubstitutionConstraint>, USignatureHasher> _substitution_constraints;
+    std::unique_ptr<InstantiationData> _inst_data;
+    std::unique_ptr<FactData> _fact_data;
+
+    // Compact replacement of ops, expansions, predecessors and op variables
+    // while the position is frozen
+    mutable std::unique_ptr<FrozenPosition> _frozen;
+    // Location of the frozen data in a spill file (offset -1: not written)
+    SpillFile* _spill_file = nullptr;
+    long _spill_offset = -1;
+    size_t _spill_size = 0;
+    // true iff _frozen is known to equal the spilled data (i.e., was paged in)
+    mutable bool _frozen_is_spilled = false;
+    // true iff the frozen data currently only resides in the spill file
+    mutable bool _spilled = false;
 
     size_t _max_expansion_size = 1;
 
@@ -66,6 +95,16 @@ private:
     bool _has_primitive_ops = false;
     bool _has_nonprimitive_ops = false;
 
+    // If true, the reductions of this position are not expanded at the next layer
+    // but repeated unchanged (and the position has a single successor)
+    bool _deferred = false;
+
+    inline const FrozenPosition& getFrozen() const {
+        if (_spilled) pageIn();
+        return *_frozen;
+    }
+    void pageIn() const;
+
 public:
 
     Position();
@@ -106,6 +145,7 @@ public:
     void removeReductionOccurrence(const USignature& reduction);
     void replaceOperation(const USignature& from, const USignature& to, Substitution&& s);
 
+    // The op table is only available while the position is not frozen (see forEachOpVariable)
     const NodeHashMap<USignature, int, USignatureHasher>& getVariableTable(VarType type) const;
     void setVariableTable(VarType type, const NodeHashMap<USignature, int, USignatureHasher>& table);
     void moveVariableTable(VarType type, Position& destination);
@@ -123,36 +163,97 @@ public:
     IndirectFactSupportMap& getPosIndirectFactSupports();
     IndirectFactSupportMap& getNegIndirectFactSupports();
     const NodeHashMap<USignature, std::vector<TypeConstraint>, USignatureHasher>& getQConstantsTypeConstraints() const;
-    NodeHashMap<USignature, std::vector<SubstitutionConstraint>, USignatureHasher>& getSubstitutionConstraints() {
-        return _substitution_constraints;
+    NodeHashMap<USignature, SubstitutionConstraintIndex, USignatureHasher>& getSubstitutionConstraints() {
+        return instData().substitution_constraints;
     }
 
     USigSet& getActions();
-    const USigSet& getReductions() const;
+    USigSet& getReductions();
     NodeHashMap<USignature, USigSet, USignatureHasher>& getExpansions();
     NodeHashMap<USignature, USigSet, USignatureHasher>& getPredecessors();
     const NodeHashMap<USignature, USigSubstitutionMap, USignatureHasher>& getExpansionSubstitutions() const;
     const USigSet& getAxiomaticOps() const;
     size_t getMaxExpansionSize() const;
+    void setDeferred(bool deferred) {_deferred = deferred;}
+    bool isDeferred() const {return _deferred;}
 
     size_t getLayerIndex() const;
     size_t getPositionIndex() const;
     
+    // Converts ops, expansions, predecessors and op variables into a compact immutable form.
+    // Any later modification (or non-const access) restores the mutable form.
+    void freeze();
+    void thaw();
+    bool isFrozen() const {return _frozen || _spilled;}
+
+    // Moves the frozen data of this position into the spill file.
+    // It is paged back in as soon as it is accessed. Data which equals 
+    // the spilled copy (e.g., after thawing without changes) is not written again.
+    void spill(SpillFile& file);
+    bool isSpilled() const {return _spilled;}
+
+    // Read-only queries on expansions and predecessors which do not thaw a frozen position.
+    // The signatures passed to f are only valid during the call.
+    bool hasPredecessors(const USignature& child) const;
+    size_t getNumPredecessors(const USignature& child) const;
+    template <typename F>
+    void forEachPredecessor(const USignature& child, F f) const {
+        if (isFrozen()) {
+            const FrozenPosition& frozen = getFrozen();
+            long i = frozen.predecessorChildren.find(child);
+            if (i < 0) return;
+            for (size_t j = frozen.predecessorOffsets[i]; j < frozen.predecessorOffsets[i+1]; j++) 
+                f(frozen.predecessorParents.get(j));
+        } else {
+            auto it = _predecessors.find(child);
+            if (it != _predecessors.end()) for (const auto& parent : it->second) f(parent);
+        }
+    }
+    size_t getNumExpansions(const USignature& parent) const;
+    bool hasExpansion(const USignature& parent, const USignature& child) const;
+    template <typename F>
+    void forEachExpansion(const USignature& parent, F f) const {
+        if (isFrozen()) {
+            const FrozenPosition& frozen = getFrozen();
+            long i = frozen.expansionParents.find(parent);
+            if (i < 0) return;
+            for (size_t j = frozen.expansionOffsets[i]; j < frozen.expansionOffsets[i+1]; j++) 
+                f(frozen.expansionChildren.get(j));
+        } else {
+            auto it = _expansions.find(parent);
+            if (it != _expansions.end()) for (const auto& child : it->second) f(child);
+        }
+    }
+
+    // Calls f(sig, var) for each encoded operation, also if the position is frozen.
+    template <typename F>
+    void forEachOpVariable(F f) const {
+        if (isFrozen()) {
+            const FrozenPosition& frozen = getFrozen();
+            for (size_t i = 0; i < frozen.opSigs.size(); i++) f(frozen.opSigs.get(i), frozen.opVars[i]);
+        } else {
+            for (const auto& [sig, var] : _op_variables) f(sig, var);
+        }
+    }
+
     void clearAfterInstantiation();
     void clearAtPastPosition();
     void clearAtPastLayer();
     void clearSubstitutions() {
-        _substitution_constraints.clear();
-        _substitution_constraints.reserve(0);
+        if (_inst_data) {
+            _inst_data->substitution_constraints.clear();
+            _inst_data->substitution_constraints.reserve(0);
+        }
     }
 
     inline int encode(VarType type, const USignature& sig) {
+        if (isFrozen() && type == OP) thaw();
         auto& vars = type == OP ? _op_variables : _fact_variables;
         auto it = vars.find(sig);
         if (it == vars.end()) {
             // introduce a new variable
             assert(!VariableDomain::isLocked() || Log::e("Unknown variable %s queried!\n", VariableDomain::varName(_layer_idx, _pos, sig).c_str()));
-            int var = VariableDomain::nextVar();
+            int var = VariableDomain::nextVar(type == OP ? VAR_OP : VAR_FACT, _layer_idx, _pos, sig._name_id);
             vars[sig] = var;
             VariableDomain::printVar(var, _layer_idx, _pos, sig);
             return var;
@@ -160,6 +261,7 @@ public:
     }
 
     inline int setVariable(VarType type, const USignature& sig, int var) {
+        if (isFrozen() && type == OP) thaw();
         auto& vars = type == OP ? _op_variables : _fact_variables;
         assert(!vars.count(sig));
         vars[sig] = var;
@@ -167,16 +269,23 @@ public:
     }
 
     inline bool hasVariable(VarType type, const USignature& sig) const {
+        if (isFrozen() && type == OP) return getFrozen().opSigs.find(sig) >= 0;
         return (type == OP ? _op_variables : _fact_variables).count(sig);
     }
 
     inline int getVariable(VarType type, const USignature& sig) const {
+        if (isFrozen() && type == OP) {
+            int var = getFrozen().getOpVariableOrZero(sig);
+            assert(var != 0 || Log::e("Unknown variable %s queried!\n", VariableDomain::varName(_layer_idx, _pos, sig).c_str()));
+            return var;
+        }
         auto& vars = type == OP ? _op_variables : _fact_variables;
         assert(vars.count(sig) || Log::e("Unknown variable %s queried!\n", VariableDomain::varName(_layer_idx, _pos, sig).c_str()));
         return vars.at(sig);
     }
 
     inline int getVariableOrZero(VarType type, const USignature& sig) const {
+        if (isFrozen() && type == OP) return getFrozen().getOpVariableOrZero(sig);
         auto& vars = type == OP ? _op_variables : _fact_variables;
         const auto& it = vars.find(sig);
         if (it == vars.end()) return 0;
@@ -184,9 +293,20 @@ public:
     }
 
     inline void removeVariable(VarType type, const USignature& sig) {
+        if (isFrozen() && type == OP) thaw();
         auto& vars = type == OP ? _op_variables : _fact_variables;
         vars.erase(sig);
     }
+
+private:
+    inline InstantiationData& instData() {
+        if (!_inst_data) _inst_data.reset(new InstantiationData());
+        return *_inst_data;
+    }
+    inline FactData& factData() {
+        if (!_fact_data) _fact_data.reset(new FactData());
+        return *_fact_data;
+    }
 };
 
 
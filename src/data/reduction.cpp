@@ -5,11 +5,10 @@
 
 Reduction::Reduction() : HtnOp() {}
 Reduction::Reduction(HtnOp& op) : HtnOp(op) {}
-Reduction::Reduction(const Reduction& r) : HtnOp(r._id, r._args), _task_name_id(r._task_name_id), _task_args(r._task_args), _subtasks(r._subtasks) {
-    for (auto pre : r.getPreconditions()) addPrecondition(pre);
-    for (auto pre : r.getExtraPreconditions()) addExtraPrecondition(pre);
-    for (auto eff : r.getEffects()) addEffect(eff);
-}
+Reduction::Reduction(HtnOp&& op) : HtnOp(std::move(op)) {}
+Reduction::Reduction(const Reduction& r) : HtnOp(r), _task_name_id(r._task_name_id), _task_args(r._task_args), _subtasks(r._subtasks) {}
+Reduction::Reduction(Reduction&& r) : HtnOp(std::move(r)), _task_name_id(r._task_name_id), 
+        _task_args(std::move(r._task_args)), _subtasks(std::move(r._subtasks)) {}
 Reduction::Reduction(int nameId, const std::vector<int>& args, const USignature& task) : 
         HtnOp(nameId, args), _task_name_id(task._name_id), _task_args(task._args) {}
 Reduction::Reduction(int nameId, const std::vector<int>& args, USignature&& task) : 
@@ -29,8 +28,7 @@ void Reduction::orderSubtasks(const std::map<int, std::vector<int>>& orderingNod
 }
 
 Reduction Reduction::substituteRed(const Substitution& s) const {
-    HtnOp op = HtnOp::substitute(s);
-    Reduction r(op);
+    Reduction r(HtnOp::substitute(s));
     
     r._task_name_id = _task_name_id;
     
@@ -79,4 +77,11 @@ Reduction& Reduction::operator=(const Reduction& other) {
     _task_args = other._task_args;
     _subtasks = other._subtasks;
     return *this;
+}
+Reduction& Reduction::operator=(Reduction&& other) {
+    HtnOp::operator=(std::move(other));
+    _task_name_id = other._task_name_id;
+    _task_args = std::move(other._task_args);
+    _subtasks = std::move(other._subtasks);
+    return *this;
 }
\ No newline at end of file
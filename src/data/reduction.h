@@ -23,7 +23,9 @@ private:
 public:
     Reduction();
     Reduction(HtnOp& op);
+    Reduction(HtnOp&& op);
     Reduction(const Reduction& r);
+    Reduction(Reduction&& r);
     Reduction(int nameId, const std::vector<int>& args, const USignature& task);
     Reduction(int nameId, const std::vector<int>& args, USignature&& task);
 
@@ -40,6 +42,7 @@ public:
     const std::vector<USignature>& getSubtasks() const;
 
     Reduction& operator=(const Reduction& other);
+    Reduction& operator=(Reduction&& other);
 };
 
 #endif
\ No newline at end of file
@@ -18,11 +18,8 @@ USignature USignature::substitute(const Substitution& s) const {
 }
 
 void USignature::apply(const Substitution& s) {
-    for (size_t i = 0; i < _args.size(); i++) {
-        auto it = s.find(_args[i]);
-        if (it != s.end()) _args[i] = it->second;
-        assert(_args[i] != 0);
-    }
+    s.apply(_args);
+    assert(std::find(_args.begin(), _args.end(), 0) == _args.end());
 }
 
 USignature USignature::renamed(int nameId) const {
@@ -67,7 +64,9 @@ Signature Signature::Signature::opposite() const {
 }
 
 Signature Signature::substitute(const Substitution& s) const {
-    return Signature(_usig.substitute(s), _negated);
+    Signature sig(*this);
+    sig.apply(s);
+    return sig;
 }
 
 void Signature::apply(const Substitution& s) {
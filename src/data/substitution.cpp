@@ -8,8 +8,12 @@ Substitution::Entry::Entry(const Entry& other) : first(other.first), second(othe
 
 Substitution::Substitution() {}
 
-Substitution::Substitution(const Substitution& other) : _entries(other._entries) {}
-Substitution::Substitution(Substitution&& old) : _entries(std::move(old._entries)) {}
+Substitution::Substitution(const Substitution& other) {
+    *this = other;
+}
+Substitution::Substitution(Substitution&& old) {
+    *this = std::move(old);
+}
 
 Substitution::Substitution(const std::vector<int>& src, const std::vector<int>& dest) {
     assert(src.size() == dest.size());
@@ -21,22 +25,46 @@ Substitution::Substitution(const std::vector<int>& src, const std::vector<int>&
     }
 }
 
+Substitution& Substitution::operator=(const Substitution& other) {
+    if (this == &other) return *this;
+    _size = other._size;
+    if (other._heap.empty()) {
+        _heap.clear();
+        std::copy(other._inline, other._inline+_size, _inline);
+    } else {
+        _heap = other._heap;
+    }
+    return *this;
+}
+
+Substitution& Substitution::operator=(Substitution&& other) {
+    if (this == &other) return *this;
+    _size = other._size;
+    if (other._heap.empty()) {
+        _heap.clear();
+        std::copy(other._inline, other._inline+_size, _inline);
+    } else {
+        _heap = std::move(other._heap);
+        other._heap.clear();
+    }
+    other._size = 0;
+    return *this;
+}
+
 void Substitution::clear() {
-    _entries.clear();
+    _heap.clear();
+    _size = 0;
 }
 
 bool Substitution::empty() const {
-    return _entries.empty();
+    return _size == 0;
 }
 
 size_t Substitution::size() const {
-    size_t size = 0;
-    auto it = _entries.begin();
-    while (it != _entries.end()) {++it; size++;}
-    return size;
+    return _size;
 }
 
-Substitution Substitution::concatenate(const Substitution& second) const {
+Substitution Substitution::concatenate(const Substitution& second) const & {
     Substitution s;
     for (const auto& [src, dest] : *this) {
         if (second.count(dest)) {
@@ -51,6 +79,20 @@ Substitution Substitution::concatenate(const Substitution& second) const {
     return s;
 }
 
+Substitution Substitution::concatenate(const Substitution& second) && {
+    // Map the values of this substitution in place
+    Entry* entries = data();
+    for (size_t i = 0; i < _size; i++) {
+        auto it = second.find(entries[i].second);
+        if (it != second.end()) entries[i].second = it->second;
+    }
+    for (const auto& [src, dest] : second) {
+        size_t pos = lowerBound(src);
+        if (pos == _size || data()[pos].first != src) insertAt(pos, src, dest);
+    }
+    return std::move(*this);
+}
+
 std::vector<Substitution> Substitution::getAll(const std::vector<int>& src, const std::vector<int>& dest) {
     std::vector<Substitution> ss;
     ss.emplace_back(); // start with empty substitution
@@ -83,9 +125,9 @@ std::vector<Substitution> Substitution::getAll(const std::vector<int>& src, cons
     return ss;
 }
 
-std::forward_list<Substitution::Entry>::const_iterator Substitution::begin() const {
-    return _entries.begin();
+const Substitution::Entry* Substitution::begin() const {
+    return data();
 }
-std::forward_list<Substitution::Entry>::const_iterator Substitution::end() const {
-    return _entries.end();
+const Substitution::Entry* Substitution::end() const {
+    return data()+_size;
 }
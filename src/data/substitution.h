@@ -3,11 +3,15 @@
 #define DOMPASCH_LILOTANE_SUBSTITUTION_H
 
 #include <vector>
-#include <forward_list>
+#include <algorithm>
 
 #include "util/hashmap.h"
 #include "util/hash.h"
 
+/*
+Mapping from ints to ints, stored as a vector of entries sorted by key.
+Up to INLINE_CAPACITY entries are stored inline without any heap allocation.
+*/
 class Substitution {
 
 public:
@@ -15,15 +19,57 @@ public:
         int first; 
         int second;
 
+        Entry() = default;
         Entry(int first, int second);
         Entry(const Entry& other);
+        Entry& operator=(const Entry& other) = default;
         inline bool operator==(const Entry& other) const {
             return first == other.first && second == other.second;
         }
     };
 
+    static const size_t INLINE_CAPACITY = 4;
+    // Above this size, entries are found via binary search instead of a linear scan
+    static const size_t LINEAR_SEARCH_LIMIT = 8;
+
 private:
-    std::forward_list<Entry> _entries;
+    Entry _inline[INLINE_CAPACITY];
+    // Holds all entries once there are more than INLINE_CAPACITY of them
+    std::vector<Entry> _heap;
+    size_t _size = 0;
+
+    inline Entry* data() {return _heap.empty() ? _inline : _heap.data();}
+    inline const Entry* data() const {return _heap.empty() ? _inline : _heap.data();}
+
+    // Position of the first entry with a key not smaller than the provided key
+    inline size_t lowerBound(int key) const {
+        const Entry* entries = data();
+        if (_size <= LINEAR_SEARCH_LIMIT) {
+            size_t i = 0;
+            while (i < _size && entries[i].first < key) i++;
+            return i;
+        }
+        return std::lower_bound(entries, entries+_size, key, [](const Entry& e, int k) {
+            return e.first < k;
+        }) - entries;
+    }
+
+    inline Entry& insertAt(size_t pos, int key, int val) {
+        if (_heap.empty() && _size < INLINE_CAPACITY) {
+            for (size_t i = _size; i > pos; i--) _inline[i] = _inline[i-1];
+            _inline[pos] = Entry(key, val);
+            _size++;
+            return _inline[pos];
+        }
+        if (_heap.empty()) {
+            // Move to heap storage
+            _heap.reserve(2*INLINE_CAPACITY);
+            _heap.assign(_inline, _inline+_size);
+        }
+        _heap.insert(_heap.begin()+pos, Entry(key, val));
+        _size++;
+        return _heap[pos];
+    }
 
 public:
     Substitution();
@@ -36,10 +82,21 @@ public:
     size_t size() const;
     bool empty() const;
 
-    Substitution concatenate(const Substitution& second) const;
+    Substitution concatenate(const Substitution& second) const &;
+    // Concatenation which reuses the memory of this substitution.
+    Substitution concatenate(const Substitution& second) &&;
 
-    std::forward_list<Entry>::const_iterator begin() const;
-    std::forward_list<Entry>::const_iterator end() const;
+    // Replaces each value in args which is a key of this substitution.
+    inline void apply(std::vector<int>& args) const {
+        if (_size == 0) return;
+        for (int& arg : args) {
+            size_t pos = lowerBound(arg);
+            if (pos < _size && data()[pos].first == arg) arg = data()[pos].second;
+        }
+    }
+
+    const Entry* begin() const;
+    const Entry* end() const;
 
     //static Substitution get(const std::vector<int>& src, const std::vector<int>& dest);
     static std::vector<Substitution> getAll(const std::vector<int>& src, const std::vector<int>& dest);
@@ -57,37 +114,9 @@ public:
     };
 
     inline int& operator[](const int& key) {
-
-        auto it = _entries.begin();
-
-        // Empty list?
-        if (it == _entries.end()) {
-            _entries.emplace_front(key, 0);
-            return _entries.begin()->second;
-        }
-
-        // Scan entries
-        auto nextIt = _entries.begin();
-        while (it != _entries.end()) {
-            
-            // Key found: return associated value
-            if (it->first == key) return it->second;
-            
-            // Peek next position
-            ++nextIt;
-
-            // Break if this is the position to insert
-            if (nextIt == _entries.end() || nextIt->first > key) break;
-
-            // Proceed to next position
-            ++it;
-        }
-        
-        // Insert, make iterator point to inserted entry
-        _entries.emplace_after(it, key, 0);
-        ++it;
-
-        return it->second;
+        size_t pos = lowerBound(key);
+        if (pos < _size && data()[pos].first == key) return data()[pos].second;
+        return insertAt(pos, key, 0).second;
     }
 
     inline int operator[](const int& key) const {
@@ -95,41 +124,36 @@ public:
     }
 
     inline int at(const int& key) const {
-        auto it = _entries.begin();
-        while (it != _entries.end() && it->first != key) ++it;
-        return it->second;
+        return find(key)->second;
     }
 
-    inline std::forward_list<Substitution::Entry>::const_iterator find(int key) const {
-        auto it = _entries.begin();
-        while (it != _entries.end() && it->first != key) ++it;
-        return it;
+    inline const Entry* find(int key) const {
+        size_t pos = lowerBound(key);
+        if (pos < _size && data()[pos].first == key) return data()+pos;
+        return end();
     }
 
-    inline std::forward_list<Substitution::Entry>::iterator find(int key) {
-        std::forward_list<Substitution::Entry>::iterator it = _entries.begin();
-        while (it != _entries.end() && it->first != key) ++it;
-        return it;
+    inline Entry* find(int key) {
+        size_t pos = lowerBound(key);
+        if (pos < _size && data()[pos].first == key) return data()+pos;
+        return data()+_size;
     }
 
     inline int count(const int& key) const {
-        auto it = _entries.begin();
-        while (it != _entries.end() && it->first != key) ++it;
-        return it != _entries.end();
+        return find(key) != end();
     }
 
 
     inline bool operator==(const Substitution& other) const {
-        return _entries == other._entries;
+        return _size == other._size && std::equal(begin(), end(), other.begin());
     }
 
     inline bool operator!=(const Substitution& other) const {
         return !(*this == other);
     }
 
-    inline void operator=(const Substitution& other) {
-        _entries = other._entries;
-    }
+    Substitution& operator=(const Substitution& other);
+    Substitution& operator=(Substitution&& other);
 
 private:
     inline void add(int key, int val) {
@@ -0,0 +1,94 @@
+
+#ifndef DOMPASCH_LILOTANE_SUBSTITUTION_CONSTRAINT_INDEX_H
+#define DOMPASCH_LILOTANE_SUBSTITUTION_CONSTRAINT_INDEX_H
+
+#include <algorithm>
+
+#include "data/substitution_constraint.h"
+#include "util/hashmap.h"
+
+/*
+Holds the substitution constraints of a single operation, grouped by
+the tuple of q-constants they involve. Mergeable constraints are merged
+on insertion, and the constraints relevant for a given q-constant tuple
+can be looked up without scanning all constraints of the operation.
+*/
+class SubstitutionConstraintIndex {
+
+private:
+    std::vector<SubstitutionConstraint> _constraints;
+
+    // involved q-constants -> indices of constraints (one per polarity at most)
+    FlatHashMap<std::vector<int>, std::vector<size_t>, IntVecHasher> _by_involved_q_consts;
+    // single q-constant -> indices of constraints involving it
+    FlatHashMap<int, std::vector<size_t>> _by_q_const;
+    // indices of constraints with polarity NO_INVALID
+    std::vector<size_t> _no_invalid;
+
+public:
+    void add(SubstitutionConstraint&& c) {
+        auto& group = _by_involved_q_consts[c.getInvolvedQConstants()];
+        for (size_t idx : group) {
+            if (_constraints[idx].canMerge(c)) {
+                _constraints[idx].merge(std::move(c));
+                return;
+            }
+        }
+        size_t idx = _constraints.size();
+        group.push_back(idx);
+        for (int qconst : c.getInvolvedQConstants()) _by_q_const[qconst].push_back(idx);
+        if (c.getPolarity() == SubstitutionConstraint::NO_INVALID) _no_invalid.push_back(idx);
+        _constraints.push_back(std::move(c));
+    }
+
+    // Collects the constraints involving exactly the provided q-constants ("fitting")
+    // and all other constraints which are able to invalidate a decoding of them, i.e.,
+    // all NO_INVALID constraints and all constraints over a superset of the q-constants.
+    void getApplicableConstraints(const std::vector<int>& involvedQConsts,
+            std::vector<const SubstitutionConstraint*>& fitting,
+            std::vector<const SubstitutionConstraint*>& others) const {
+
+        std::vector<size_t> fittingIndices;
+        auto it = _by_involved_q_consts.find(involvedQConsts);
+        if (it != _by_involved_q_consts.end()) fittingIndices = it->second;
+        for (size_t idx : fittingIndices) fitting.push_back(&_constraints[idx]);
+
+        auto isFitting = [&](size_t idx) {
+            return std::find(fittingIndices.begin(), fittingIndices.end(), idx) != fittingIndices.end();
+        };
+
+        // Candidates for supersets: constraints involving the rarest of the q-constants
+        const std::vector<size_t>* candidates = nullptr;
+        for (int qconst : involvedQConsts) {
+            auto qIt = _by_q_const.find(qconst);
+            if (qIt == _by_q_const.end()) {
+                candidates = nullptr;
+                break;
+            }
+            if (candidates == nullptr || qIt->second.size() < candidates->size())
+                candidates = &qIt->second;
+        }
+
+        std::vector<size_t> otherIndices;
+        for (size_t idx : _no_invalid) if (!isFitting(idx)) otherIndices.push_back(idx);
+        if (involvedQConsts.empty()) {
+            for (size_t idx = 0; idx < _constraints.size(); idx++)
+                if (!isFitting(idx)) otherIndices.push_back(idx);
+        } else if (candidates != nullptr) {
+            for (size_t idx : *candidates) {
+                if (isFitting(idx)) continue;
+                if (_constraints[idx].involvesSupersetOf(involvedQConsts)) otherIndices.push_back(idx);
+            }
+        }
+        std::sort(otherIndices.begin(), otherIndices.end());
+        otherIndices.erase(std::unique(otherIndices.begin(), otherIndices.end()), otherIndices.end());
+        for (size_t idx : otherIndices) others.push_back(&_constraints[idx]);
+    }
+
+    size_t size() const {return _constraints.size();}
+    bool empty() const {return _constraints.empty();}
+    std::vector<SubstitutionConstraint>::const_iterator begin() const {return _constraints.begin();}
+    std::vector<SubstitutionConstraint>::const_iterator end() const {return _constraints.end();}
+};
+
+#endif
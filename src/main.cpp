@@ -85,7 +85,8 @@ int main(int argc, char** argv) {
         Log::log_notime(Log::V0_ESSENTIAL, "L i l o t a n e");
         Log::log_notime(Log::V0_ESSENTIAL, "  version %s\n", LILOTANE_VERSION);
         Log::log_notime(Log::V0_ESSENTIAL, "by Dominik Schreiber <dominik.schreiber@kit.edu> 2020-2021\n");
-        Log::log_notime(Log::V0_ESSENTIAL, "using SAT solver %s\n", IPASIRSOLVER);
+        Log::log_notime(Log::V0_ESSENTIAL, "using SAT solver %s\n",
+            params.isSet("solver") ? params.getParam("solver").c_str() : IPASIRSOLVER);
         Log::log_notime(Log::V0_ESSENTIAL, "\n");
     }
 
@@ -41,11 +41,11 @@ public:
 
             int chosenActions = 0;
             //State newState = state;
-            for (const auto& [sig, aVar] : finalLayer[pos].getVariableTable(VarType::OP)) {
-                if (!_sat.holds(aVar)) continue;
+            finalLayer[pos].forEachOpVariable([&](const USignature& sig, int aVar) {
+                if (!_sat.holds(aVar)) return;
 
                 USignature aSig = sig;
-                if (mode == PRIMITIVE_ONLY && !_htn.isAction(aSig)) continue;
+                if (mode == PRIMITIVE_ONLY && !_htn.isAction(aSig)) return;
 
                 if (_htn.isActionRepetition(aSig._name_id)) {
                     aSig._name_id = _htn.getActionNameFromRepetition(sig._name_id);
@@ -59,9 +59,9 @@ public:
 
                 // Decode q constants
                 USignature aDec = getDecodedQOp(li, pos, aSig);
-                if (aDec == Sig::NONE_SIG) continue;
+                if (aDec == Sig::NONE_SIG) return;
                 plan[pos] = {aVar, aDec, aDec, std::vector<int>()};
-            }
+            });
 
             assert(chosenActions <= 1 || Log::e("Plan error: Added %i actions at step %i!\n", chosenActions, pos));
             if (chosenActions == 0) {
@@ -90,17 +90,17 @@ public:
             for (size_t pos = 0; pos < l.size(); pos++) {
 
                 size_t predPos = 0;
-                if (layerIdx > 0) {
-                    Layer& lastLayer = *_layers.at(layerIdx-1);
-                    while (predPos+1 < lastLayer.size() && lastLayer.getSuccessorPos(predPos+1) <= pos) 
-                        predPos++;
-                } 
+                if (layerIdx > 0) predPos = _layers.at(layerIdx-1)->getPredecessorPos(pos);
                 //log("%i -> %i\n", predPos, pos);
 
                 int actionsThisPos = 0;
                 int reductionsThisPos = 0;
 
-                for (const auto& [opSig, v] : l[pos].getVariableTable(VarType::OP)) {
+                // (positions of past layers may be frozen)
+                std::vector<std::pair<USignature, int>> opVars;
+                l[pos].forEachOpVariable([&](const USignature& sig, int var) {opVars.emplace_back(sig, var);});
+
+                for (const auto& [opSig, v] : opVars) {
 
                     if (_sat.holds(v)) {
 
@@ -115,7 +115,6 @@ public:
                             }
                             
                             int v = _vars.getVariable(VarType::OP, layerIdx, pos, aSig);
-                            Action a = _htn.getOpTable().getAction(aSig);
 
                             // TODO check this is a valid subtask relationship
 
@@ -143,13 +142,12 @@ public:
                         } else if (_htn.isReduction(opSig)) {
                             // Reduction
                             const USignature& rSig = opSig;
-                            const Reduction& r = _htn.getOpTable().getReduction(rSig);
 
                             //log("%s:%s @ (%i,%i)\n", TOSTR(r.getTaskSignature()), TOSTR(rSig), layerIdx, pos);
                             USignature decRSig = getDecodedQOp(layerIdx, pos, rSig);
                             if (decRSig == Sig::NONE_SIG) continue;
 
-                            Reduction rDecoded = r.substituteRed(Substitution(r.getArguments(), decRSig._args));
+                            GroundOp rDecoded = _htn.toGroundOp(decRSig);
                             Log::d("[%i] %s:%s @ (%i,%i)\n", v, TOSTR(rDecoded.getTaskSignature()), TOSTR(decRSig), layerIdx, pos);
 
                             if (layerIdx == 0) {
@@ -163,28 +161,38 @@ public:
                             }
 
                             // Lookup parent reduction
-                            Reduction parentRed;
                             size_t offset = pos - _layers.at(layerIdx-1)->getSuccessorPos(predPos);
                             PlanItem& parent = itemsOldLayer[predPos];
                             assert(parent.id >= 0 || Log::e("Plan error: No parent at %i,%i!\n", layerIdx-1, predPos));
                             assert(_htn.isReduction(parent.reduction) || 
                                 Log::e("Plan error: Invalid reduction id=%i at %i,%i!\n", parent.reduction._name_id, layerIdx-1, predPos));
 
-                            parentRed = _htn.toReduction(parent.reduction._name_id, parent.reduction._args);
+                            // Repetition of the parent reduction at a deferred position?
+                            if (_layers.at(layerIdx-1)->at(predPos).isDeferred() && parent.reduction == decRSig) {
+                                if (reductionsThisPos > 0) continue;
+                                // Move the parent's plan item down to this layer
+                                itemsNewLayer[pos] = parent;
+                                parent.id = -1;
+                                reductionsThisPos++;
+                                continue;
+                            }
+
+                            GroundOp parentRed = _htn.toGroundOp(parent.reduction);
+                            USignature rTask = rDecoded.getTaskSignature();
 
                             // Is the current reduction a proper subtask?
-                            assert(offset < parentRed.getSubtasks().size());
-                            if (parentRed.getSubtasks()[offset] == rDecoded.getTaskSignature()) {
+                            assert(offset < parentRed.getNumSubtasks());
+                            if (parentRed.getSubtask(offset) == rTask) {
                                 if (itemsOldLayer[predPos].subtaskIds.size() > offset) {
                                     // This subtask has already been written!
                                     Log::d(" -- is a redundant child -> dismiss\n");
                                     continue;
                                 }
-                                itemsNewLayer[pos] = PlanItem(v, rDecoded.getTaskSignature(), decRSig, std::vector<int>());
+                                itemsNewLayer[pos] = PlanItem(v, rTask, decRSig, std::vector<int>());
                                 itemsOldLayer[predPos].subtaskIds.push_back(v);
                                 reductionsThisPos++;
                             } else {
-                                Log::d(" -- invalid : %s != %s\n", TOSTR(parentRed.getSubtasks()[offset]), TOSTR(rDecoded.getTaskSignature()));
+                                Log::d(" -- invalid : %s != %s\n", TOSTR(parentRed.getSubtask(offset)), TOSTR(rTask));
                             }
                         }
                     }
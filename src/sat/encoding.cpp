@@ -11,10 +11,13 @@
 void Encoding::encode(size_t layerIdx, size_t pos) {
     _termination_callback();
 
-    _stats.beginPosition();
+    _stats.beginPosition(layerIdx);
+    int firstVar = VariableDomain::getMaxVar()+1;
+    if (_local_preprocessing) _sat.beginBatch();
 
     _layer_idx = layerIdx;
     _pos = pos;
+    VariableDomain::setContext(layerIdx, pos);
 
     // Calculate relevant environment of the position
     Position NULL_POS;
@@ -27,9 +30,7 @@ void Encoding::encode(size_t layerIdx, size_t pos) {
     _offset = 0, _old_pos = 0;
     if (hasAbove) {
         const Layer& oldLayer = *_layers.at(layerIdx-1);
-        while (_old_pos+1 < oldLayer.size() && oldLayer.getSuccessorPos(_old_pos+1) <= pos) 
-            _old_pos++;
-        _offset = pos - oldLayer.getSuccessorPos(_old_pos);
+        std::tie(_old_pos, _offset) = oldLayer.getPredecessorPosAndOffset(pos);
     }
     Position& above = (hasAbove ? (*_layers.at(layerIdx-1))[_old_pos] : NULL_POS);
     
@@ -70,9 +71,35 @@ void Encoding::encode(size_t layerIdx, size_t pos) {
     }
     _stats.end(STAGE_AXIOMATICOPS);
 
+    if (_seed_phases && _has_phase_hint && hasAbove) seedPhases(newPos, above);
+
+    if (_local_preprocessing) preprocessLocally(firstVar);
+
     _stats.endPosition();
 }
 
+void Encoding::preprocessLocally(int firstVar) {
+    // Auxiliary variables introduced at this position (binary AMO digits) 
+    // do not occur anywhere else; all other variables may be referenced later
+    std::vector<int> localVars;
+    for (int var = firstVar; var <= VariableDomain::getMaxVar(); var++) {
+        if (VariableDomain::getInfo(var).kind == VAR_AUX) localVars.push_back(var);
+    }
+    float time = Timer::elapsedSeconds();
+    _stats.begin(STAGE_LOCALPREPROCESSING);
+    auto [numBefore, numAfter] = _sat.endBatch(localVars);
+    _stats.end(STAGE_LOCALPREPROCESSING);
+    auto& layerStats = getLayerStatistics(_layer_idx);
+    layerStats.numClausesBefore += numBefore;
+    layerStats.numClausesAfter += numAfter;
+    layerStats.preprocessingTime += Timer::elapsedSeconds() - time;
+}
+
+Encoding::LayerStatistics& Encoding::getLayerStatistics(size_t layerIdx) {
+    if (layerIdx >= _layer_stats.size()) _layer_stats.resize(layerIdx+1);
+    return _layer_stats[layerIdx];
+}
+
 void Encoding::encodeOperationVariables(Position& newPos) {
 
     _primitive_ops.clear();
@@ -207,6 +234,7 @@ void Encoding::encodeFactVariables(Position& newPos, Position& left, Position& a
     const USigSet* cHere[] = {&newPos.getTrueFacts(), &newPos.getFalseFacts()}; 
     for (int i = 0; i < 2; i++) 
     for (const USignature& factSig : *cHere[i]) if (_analysis.isRelevant(factSig)) {
+        _stats.setContributor(factSig._name_id);
         int var = newPos.getVariableOrZero(VarType::FACT, factSig);
         if (var == 0) {
             // Variable is not encoded yet.
@@ -217,6 +245,7 @@ void Encoding::encodeFactVariables(Position& newPos, Position& left, Position& a
         }
         Log::d("(%i,%i) DEFFACT %s\n", _layer_idx, _pos, TOSTR(factSig));
     }
+    _stats.setContributor(-1);
     _stats.end(STAGE_TRUEFACTS);
 }
 
@@ -250,6 +279,7 @@ void Encoding::encodeFrameAxioms(Position& newPos, Position& left) {
     size_t skipped = 0;
     for ([[maybe_unused]] const auto& [fact, var] : left.getVariableTable(VarType::FACT)) {
         if (_htn.hasQConstants(fact)) continue;
+        _stats.setContributor(fact._name_id);
         
         int oldFactVars[2] = {-var, var};
         const USigSet* dir[2] = {nullptr, nullptr};
@@ -347,6 +377,7 @@ void Encoding::encodeFrameAxioms(Position& newPos, Position& left) {
             _sat.addClause(cls);
         }
     }
+    _stats.setContributor(-1);
     _stats.end(STAGE_DIRECTFRAMEAXIOMS);
 
     Log::d("Skipped %i frame axioms\n", skipped);
@@ -384,6 +415,7 @@ void Encoding::encodeOperationConstraints(Position& newPos) {
     _stats.begin(STAGE_ACTIONCONSTRAINTS);
     for (const auto& aSig : newPos.getActions()) {
 
+        _stats.setContributor(aSig._name_id);
         int aVar = _vars.getVariable(VarType::OP, newPos, aSig);
         elementVars[numOccurringOps++] = aVar;
         
@@ -401,6 +433,7 @@ void Encoding::encodeOperationConstraints(Position& newPos) {
     _stats.begin(STAGE_REDUCTIONCONSTRAINTS);
     for (const auto& rSig : newPos.getReductions()) {
 
+        _stats.setContributor(rSig._name_id);
         int rVar = _vars.getVariable(VarType::OP, newPos, rSig);
         for (int arg : rSig._args) encodeSubstitutionVars(rSig, rVar, arg);
         elementVars[numOccurringOps++] = rVar;
@@ -411,6 +444,7 @@ void Encoding::encodeOperationConstraints(Position& newPos) {
             _sat.addClause(-rVar, (pre._negated?-1:1)*_vars.getVariable(VarType::FACT, newPos, pre._usig));
         }
     }
+    _stats.setContributor(-1);
     _stats.end(STAGE_REDUCTIONCONSTRAINTS);
 
     _q_constants.insert(_new_q_constants.begin(), _new_q_constants.end());
@@ -488,6 +522,7 @@ void Encoding::encodeQFactSemantics(Position& newPos) {
     std::vector<int> substitutionVars; substitutionVars.reserve(128);
     for (const auto& qfactSig : newPos.getQFacts()) {
         assert(_htn.hasQConstants(qfactSig));
+        _stats.setContributor(qfactSig._name_id);
         
         int qfactVar = _vars.getVariable(VarType::FACT, newPos, qfactSig);
 
@@ -546,6 +581,7 @@ void Encoding::encodeQFactSemantics(Position& newPos) {
             }
         }
     }
+    _stats.setContributor(-1);
     _stats.end(STAGE_QFACTSEMANTICS);
 }
 
@@ -555,6 +591,7 @@ void Encoding::encodeActionEffects(Position& newPos, Position& left) {
     _stats.begin(STAGE_ACTIONEFFECTS);
     for (const auto& aSig : left.getActions()) {
         if (_htn.isActionRepetition(aSig._name_id)) continue;
+        _stats.setContributor(aSig._name_id);
         int aVar = _vars.getVariable(VarType::OP, left, aSig);
 
         const SigSet& effects = _htn.getOpTable().getAction(aSig).getEffects();
@@ -627,6 +664,7 @@ void Encoding::encodeActionEffects(Position& newPos, Position& left) {
             }
         }
     }
+    _stats.setContributor(-1);
     _stats.end(STAGE_ACTIONEFFECTS);
 }
 
@@ -638,6 +676,7 @@ void Encoding::encodeQConstraints(Position& newPos) {
     for (const auto& [opSig, constraints] : constraints) {
         int opVar = newPos.getVariableOrZero(VarType::OP, opSig);
         if (opVar != 0) {
+            _stats.setContributor(opSig._name_id);
             for (const TypeConstraint& c : constraints) {
                 int qconst = c.qconstant;
                 bool positiveConstraint = c.sign;
@@ -659,6 +698,7 @@ void Encoding::encodeQConstraints(Position& newPos) {
             }
         }
     }
+    _stats.setContributor(-1);
     _stats.end(STAGE_QTYPECONSTRAINTS);
 
     // Forbidden substitutions
@@ -670,6 +710,7 @@ void Encoding::encodeQConstraints(Position& newPos) {
 
         auto it = newPos.getSubstitutionConstraints().find(opSig);
         if (it == newPos.getSubstitutionConstraints().end()) continue;
+        _stats.setContributor(opSig._name_id);
         
         for (const auto& c : it->second) {
             auto f = c.getEncoding();
@@ -693,6 +734,7 @@ void Encoding::encodeQConstraints(Position& newPos) {
     }
     newPos.clearSubstitutions();
     
+    _stats.setContributor(-1);
     _stats.end(STAGE_SUBSTITUTIONCONSTRAINTS);
 }
 
@@ -709,6 +751,7 @@ void Encoding::encodeSubtaskRelationships(Position& newPos, Position& above) {
     _stats.begin(STAGE_EXPANSIONS);
     for (const auto& [parent, children] : newPos.getExpansions()) {
 
+        _stats.setContributor(parent._name_id);
         int parentVar = _vars.getVariable(VarType::OP, above, parent);
         _sat.appendClause(-parentVar);
         for (const USignature& child : children) {
@@ -738,6 +781,7 @@ void Encoding::encodeSubtaskRelationships(Position& newPos, Position& above) {
             }
         }
     }
+    _stats.setContributor(-1);
     _stats.end(STAGE_EXPANSIONS);
 
     // predecessors
@@ -745,12 +789,14 @@ void Encoding::encodeSubtaskRelationships(Position& newPos, Position& above) {
         _stats.begin(STAGE_PREDECESSORS);
         for (const auto& [child, parents] : newPos.getPredecessors()) {
 
+            _stats.setContributor(child._name_id);
             _sat.appendClause(-_vars.getVariable(VarType::OP, newPos, child));
             for (const USignature& parent : parents) {
                 _sat.appendClause(_vars.getVariable(VarType::OP, above, parent));
             }
             _sat.endClause();
         }
+        _stats.setContributor(-1);
         _stats.end(STAGE_PREDECESSORS);
     }
 }
@@ -760,15 +806,14 @@ int Encoding::encodeQConstEquality(int q1, int q2) {
     if (!_vars.isQConstantEqualityEncoded(q1, q2)) {
         
         _stats.begin(STAGE_QCONSTEQUALITY);
-        FlatHashSet<int> good, bad1, bad2;
-        for (int c : _htn.getDomainOfQConstant(q1)) {
-            if (!_htn.getDomainOfQConstant(q2).count(c)) bad1.insert(c);
-            else good.insert(c);
-        }
-        for (int c : _htn.getDomainOfQConstant(q2)) {
-            if (_htn.getDomainOfQConstant(q1).count(c)) continue;
-            bad2.insert(c);
-        }
+        const Bitset& domain1 = _htn.getDomainBitsetOfQConstant(q1);
+        const Bitset& domain2 = _htn.getDomainBitsetOfQConstant(q2);
+        Bitset goodBits = domain1; goodBits &= domain2;
+        Bitset bad1Bits = domain1; bad1Bits.subtract(domain2);
+        Bitset bad2Bits = domain2; bad2Bits.subtract(domain1);
+        std::vector<int> good = _htn.getConstantsOfBitset(goodBits);
+        std::vector<int> bad1 = _htn.getConstantsOfBitset(bad1Bits);
+        std::vector<int> bad2 = _htn.getConstantsOfBitset(bad2Bits);
         int varEq = _vars.encodeQConstantEqualityVar(q1, q2);
         if (good.empty()) {
             // Domains are incompatible -- equality never holds
@@ -819,27 +864,132 @@ void Encoding::setTerminateCallback(void * state, int (*terminate)(void * state)
 }
 
 void onClauseLearnt(void* state, int* cls) {
-    std::string str = "";
-    int i = 0; while (cls[i] != 0) str += std::to_string(cls[i++]) + " ";
-    Log::d("LEARNT_CLAUSE %s\n", str.c_str());
+    ((Encoding*) state)->onClauseLearnt(cls);
+}
+
+void Encoding::onClauseLearnt(const int* cls) {
+    if (_params.isNonzero("plc")) {
+        std::string str = "";
+        int i = 0; while (cls[i] != 0) str += std::to_string(cls[i++]) + " ";
+        Log::d("LEARNT_CLAUSE %s\n", str.c_str());
+    }
+    if (_profile) _profiler.onLearntClause(cls);
+    if (_learnt_unit_feedback && cls[0] < 0 && cls[1] == 0) {
+        _learnt_false_vars.push_back(-cls[0]);
+    }
 }
 
 int Encoding::solve() {
     Log::i("Attempting to solve formula with %i clauses (%i literals) and %i assumptions\n", 
                 _stats._num_cls, _stats._num_lits, _stats._num_asmpts);
     
-    if (_params.isNonzero("plc"))
-        _sat.setLearnCallback(/*maxLength=*/100, this, onClauseLearnt);
+    if (_params.isNonzero("plc") || _profile)
+        _sat.setLearnCallback(/*maxLength=*/100, this, ::onClauseLearnt);
+    else if (_learnt_unit_feedback)
+        _sat.setLearnCallback(/*maxLength=*/1, this, ::onClauseLearnt);
+
+    if (_classify_variables) classifyNewVariables();
 
+    int result;
     _sat_call_start_time = Timer::elapsedSeconds();
-    int result = _sat.solve();
+    if (_seed_phases && !_pending_phases.empty()) {
+        if (_sat.supportsPhases()) {
+            Log::v("Setting %i variable phases\n", _pending_phases.size());
+            for (int lit : _pending_phases) _sat.setPhase(std::abs(lit), lit > 0);
+            _num_seeded_phases += _pending_phases.size();
+            result = _sat.solve();
+        } else {
+            // Fallback: Try the seeded operations as assumptions first
+            Log::v("Solver does not support phases - using %i operations as hints\n", _hinted_ops.size());
+            result = _sat.solveWithHints(_hinted_ops);
+        }
+        _pending_phases.clear();
+        _hinted_ops.clear();
+    } else {
+        result = _sat.solve();
+    }
+    getLayerStatistics(_layers.size()-1).solvingTime += Timer::elapsedSeconds() - _sat_call_start_time;
     _sat_call_start_time = 0;
 
+    if (_seed_phases && result == 10) rememberAssignment();
+    if (_profile && result == 20) profileFailedAssumptions();
+
     _termination_callback();
 
     return result;
 }
 
+void Encoding::seedPhases(Position& newPos, Position& above) {
+
+    // Only operations of the most recent layer are used as hints
+    if (newPos.getPositionIndex() == 0) _hinted_ops.clear();
+
+    // Operations: true iff one of their predecessors was true
+    for (const auto& [child, parents] : newPos.getPredecessors()) {
+        int var = newPos.getVariableOrZero(VarType::OP, child);
+        if (var == 0) continue;
+        bool phase = false;
+        for (const USignature& parent : parents) {
+            int parentVar = above.getVariableOrZero(VarType::OP, parent);
+            if (parentVar != 0 && _phase_hint.test(parentVar)) {
+                phase = true;
+                break;
+            }
+        }
+        addPhase(var, phase);
+        if (phase) _hinted_ops.push_back(var);
+    }
+
+    // Facts: value of the fact at the position above
+    // (inherited fact variables already carry their value)
+    for (const auto& [fact, var] : newPos.getVariableTable(VarType::FACT)) {
+        int aboveVar = above.getVariableOrZero(VarType::FACT, fact);
+        if (aboveVar == 0 || aboveVar == var) continue;
+        addPhase(var, _phase_hint.test(aboveVar));
+    }
+}
+
+void Encoding::addPhase(int var, bool phase) {
+    _pending_phases.push_back(phase ? var : -var);
+    // Seeded phases serve as hints for the next layer if this layer is not solved
+    _phase_hint.grow(var+1);
+    _phase_hint.set(var, phase);
+}
+
+void Encoding::rememberAssignment() {
+    Layer& layer = *_layers.back();
+    _phase_hint.clear();
+    _phase_hint.grow(VariableDomain::getMaxVar()+1);
+    for (size_t pos = 0; pos < layer.size(); pos++) {
+        layer[pos].forEachOpVariable([&](const USignature&, int var) {
+            if (_sat.holds(var)) _phase_hint.set(var);
+        });
+        for (const auto& [fact, var] : layer[pos].getVariableTable(VarType::FACT)) {
+            if (_sat.holds(var)) _phase_hint.set(var);
+        }
+    }
+    _has_phase_hint = true;
+}
+
+void Encoding::classifyNewVariables() {
+    int maxVar = VariableDomain::getMaxVar();
+    for (int var = _num_classified_vars+1; var <= maxVar; var++) {
+        switch (_vars.getRole(var)) {
+        case ROLE_INTERFACE:
+            _sat.setFrozen(var, true);
+            _num_interface_vars++;
+            // fall through
+        case ROLE_AUXILIARY:
+            _sat.setDecisionVar(var, false);
+            _num_auxiliary_vars++;
+            break;
+        case ROLE_DECISION:
+            break;
+        }
+    }
+    _num_classified_vars = maxVar;
+}
+
 void Encoding::addUnitConstraint(int lit) {
     _stats.begin(STAGE_FORBIDDENOPERATIONS);
     _sat.addClause(lit);
@@ -861,6 +1011,28 @@ void Encoding::printFailedVars(Layer& layer) {
     Log::d("\n");
 }
 
+void Encoding::profileFailedAssumptions() {
+    Layer& layer = *_layers.back();
+    std::vector<bool> failed = getFailedPositions(layer);
+    for (size_t pos = 0; pos < layer.size(); pos++) {
+        if (!failed[pos]) continue;
+        std::vector<int> opNameIds;
+        for (const auto* ops : {&layer[pos].getActions(), &layer[pos].getReductions()}) {
+            for (const USignature& op : *ops) opNameIds.push_back(op._name_id);
+        }
+        _profiler.onFailedAssumption(opNameIds);
+    }
+}
+
+std::vector<bool> Encoding::getFailedPositions(Layer& layer) {
+    std::vector<bool> failed(layer.size(), false);
+    for (size_t pos = 0; pos < layer.size(); pos++) {
+        int v = _vars.getVarPrimitiveOrZero(layer.index(), pos);
+        if (v != 0 && _sat.didAssumptionFail(v)) failed[pos] = true;
+    }
+    return failed;
+}
+
 void Encoding::printSatisfyingAssignment() {
     Log::d("SOLUTION_VALS ");
     for (int v = 1; v <= _vars.getNumVariables(); v++) {
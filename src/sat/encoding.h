@@ -9,9 +9,11 @@
 #include "data/action.h"
 #include "sat/literal_tree.h"
 #include "sat/sat_interface.h"
+#include "sat/sat_profiler.h"
 #include "algo/fact_analysis.h"
 #include "sat/variable_provider.h"
 #include "sat/decoder.h"
+#include "util/bitset.h"
 
 typedef NodeHashMap<int, SigSet> State;
 
@@ -48,6 +50,40 @@ private:
 
     float _sat_call_start_time;
 
+    // Phase seeding: values of variables in the most recent assignment (or seeded phases)
+    // and the literals whose phases are to be set before the next solver call
+    const bool _seed_phases;
+    Bitset _phase_hint;
+    bool _has_phase_hint = false;
+    std::vector<int> _pending_phases;
+    std::vector<int> _hinted_ops;
+    size_t _num_seeded_phases = 0;
+
+    // Variables which the solver learnt to be false (as unit clauses)
+    const bool _learnt_unit_feedback;
+    std::vector<int> _learnt_false_vars;
+
+    const bool _profile;
+    SatProfiler _profiler;
+
+    // Classification of variables into decision, auxiliary and interface variables
+    const bool _classify_variables;
+    int _num_classified_vars = 0;
+    size_t _num_auxiliary_vars = 0;
+    size_t _num_interface_vars = 0;
+
+    // Preprocessing of each position's clauses w.r.t. its local auxiliary variables
+    const bool _local_preprocessing;
+public:
+    struct LayerStatistics {
+        size_t numClausesBefore = 0;
+        size_t numClausesAfter = 0;
+        float preprocessingTime = 0;
+        float solvingTime = 0;
+    };
+private:
+    std::vector<LayerStatistics> _layer_stats;
+
 public:
     Encoding(Parameters& params, HtnInstance& htn, FactAnalysis& analysis, std::vector<Layer*>& layers, std::function<void()> terminationCallback) : 
             _params(params), _htn(htn), _analysis(analysis), _layers(layers),
@@ -55,7 +91,13 @@ public:
             _decoder(_htn, _layers, _sat, _vars),
             _termination_callback(terminationCallback),
             _use_q_constant_mutexes(_params.getIntParam("qcm") > 0), 
-            _implicit_primitiveness(params.isNonzero("ip")) {}
+            _implicit_primitiveness(params.isNonzero("ip")), _seed_phases(params.isNonzero("svp")),
+            _learnt_unit_feedback(params.isNonzero("luf")),
+            _profile(params.isNonzero("prof")), _profiler(_stats),
+            _classify_variables(params.isNonzero("ndv")), 
+            _local_preprocessing(params.isNonzero("lpp")) {
+        _stats.setAttribution(std::max(0, params.getIntParam("catt")));
+    }
 
     void encode(size_t layerIdx, size_t pos);
     void addAssumptions(int layerIdx, bool permanent = false);
@@ -65,7 +107,18 @@ public:
     int solve();
     float getTimeSinceSatCallStart();    
 
+    size_t getNumSeededPhases() const {return _num_seeded_phases;}
+    size_t getNumAuxiliaryVars() const {return _num_auxiliary_vars;}
+    size_t getNumInterfaceVars() const {return _num_interface_vars;}
+    bool isLocalPreprocessing() const {return _local_preprocessing;}
+    const std::vector<LayerStatistics>& getLayerStatistics() const {return _layer_stats;}
+
     void printFailedVars(Layer& layer);
+    std::vector<bool> getFailedPositions(Layer& layer);
+
+    // Returns (and forgets) all variables learnt to be false since the last call.
+    std::vector<int> extractLearntFalseVars() {return std::move(_learnt_false_vars);}
+    void onClauseLearnt(const int* cls);
     void printSatisfyingAssignment();
 
     Plan extractPlan() {
@@ -73,6 +126,8 @@ public:
     }
     void printStatistics() {
         _stats.printStages();
+        _stats.printAttribution();
+        if (_profile) _profiler.printReport();
     }
     SatInterface& getSatInterface() {return _sat;}
     EncodingStatistics& getEncodingStatistics() {return _stats;}
@@ -95,6 +150,13 @@ private:
     void encodeActionEffects(Position& pos, Position& left);
     void encodeQConstraints(Position& pos);
     void encodeSubtaskRelationships(Position& pos, Position& above);
+    void seedPhases(Position& pos, Position& above);
+    void addPhase(int var, bool phase);
+    void rememberAssignment();
+    void profileFailedAssumptions();
+    void classifyNewVariables();
+    void preprocessLocally(int firstVar);
+    LayerStatistics& getLayerStatistics(size_t layerIdx);
     int encodeQConstEquality(int q1, int q2);
 };
 
@@ -4,9 +4,14 @@
 
 #include <vector>
 #include <map>
+#include <algorithm>
+#include <chrono>
 #include <assert.h>
 
 #include "util/log.h"
+#include "util/names.h"
+#include "util/hashmap.h"
+#include "sat/variable_domain.h"
 
 const int STAGE_ACTIONCONSTRAINTS = 0;
 const int STAGE_ACTIONEFFECTS = 1;
@@ -29,6 +34,7 @@ const int STAGE_SUBSTITUTIONCONSTRAINTS = 17;
 const int STAGE_TRUEFACTS = 18;
 const int STAGE_ASSUMPTIONS = 19;
 const int STAGE_PLANLENGTHCOUNTING = 20;
+const int STAGE_LOCALPREPROCESSING = 21;
 
 class EncodingStatistics {
 
@@ -40,45 +46,88 @@ public:
     int _prev_num_lits = 0;
 
 private:
-    const char* STAGES_NAMES[21] = {"actionconstraints","actioneffects","atleastoneelement","atmostoneelement",
+    const char* STAGES_NAMES[22] = {"actionconstraints","actioneffects","atleastoneelement","atmostoneelement",
         "axiomaticops","directframeaxioms","expansions","factpropagation","factvarencoding","forbiddenoperations",
         "indirectframeaxioms", "initsubstitutions","predecessors","qconstequality","qfactsemantics",
-        "qtypeconstraints","reductionconstraints","substitutionconstraints","truefacts","assumptions","planlengthcounting"};
+        "qtypeconstraints","reductionconstraints","substitutionconstraints","truefacts","assumptions","planlengthcounting",
+        "localpreprocessing"};
     std::vector<int> _num_cls_per_stage;
     std::vector<int> _current_stages;
     int _num_cls_at_stage_start = 0;
 
+    // Attribution of clauses, literals and time to the lifted op or predicate
+    // (name ID, -1 if none) responsible for them, measured as deltas between switches
+    struct Contribution {
+        size_t numCls = 0;
+        size_t numLits = 0;
+        double time = 0;
+    };
+    size_t _attribution_top_k = 0;
+    int _layer_idx = 0;
+    int _contributor = -1;
+    int _num_cls_at_attribution_start = 0;
+    int _num_lits_at_attribution_start = 0;
+    double _time_at_attribution_start = 0;
+    // layer -> (contributor, stage) -> contribution
+    std::vector<FlatHashMap<uint64_t, Contribution>> _contributions;
+
 public:
     EncodingStatistics() {
         _num_cls_per_stage.resize(sizeof(STAGES_NAMES)/sizeof(*STAGES_NAMES));
     }
 
-    void beginPosition() {
+    void setAttribution(size_t topK) {_attribution_top_k = topK;}
+    bool isAttributing() const {return _attribution_top_k > 0;}
+
+    void beginPosition(int layerIdx) {
         _prev_num_cls = _num_cls;
         _prev_num_lits = _num_lits;
+        if (!isAttributing()) return;
+        _layer_idx = layerIdx;
+        _contributor = -1;
+        resetAttribution();
+    }
+
+    // Attributes all clauses emitted from now on to the provided name ID
+    // (lifted op or predicate; -1 for none) until the next call.
+    inline void setContributor(int nameId) {
+        if (!isAttributing() || nameId == _contributor) return;
+        flushAttribution();
+        _contributor = nameId;
     }
 
     void endPosition() {
         assert(_current_stages.empty());
+        if (isAttributing()) {
+            flushAttribution();
+            _contributor = -1;
+        }
         Log::v("  Encoded %i cls, %i lits\n", _num_cls-_prev_num_cls, _num_lits-_prev_num_lits);
     }
 
     void begin(int stage) {
+        if (isAttributing()) flushAttribution();
         if (!_current_stages.empty()) {
             int oldStage = _current_stages.back();
             _num_cls_per_stage[oldStage] += _num_cls - _num_cls_at_stage_start;
         }
         _num_cls_at_stage_start = _num_cls;
         _current_stages.push_back(stage);
+        VariableDomain::setStage(stage);
     }
 
     void end(int stage) {
         assert(!_current_stages.empty() && _current_stages.back() == stage);
+        if (isAttributing()) flushAttribution();
         _current_stages.pop_back();
         _num_cls_per_stage[stage] += _num_cls - _num_cls_at_stage_start;
         _num_cls_at_stage_start = _num_cls;
+        VariableDomain::setStage(_current_stages.empty() ? -1 : _current_stages.back());
     }
 
+    int getNumStages() const {return sizeof(STAGES_NAMES)/sizeof(*STAGES_NAMES);}
+    const char* getStageName(int stage) const {return stage >= 0 ? STAGES_NAMES[stage] : "none";}
+
     void printStages() {
         Log::i("Total amount of clauses encoded: %i\n", _num_cls);
         std::map<int, int, std::greater<int>> stagesSorted;
@@ -92,9 +141,82 @@ public:
         _num_cls_per_stage.clear();
     }
 
+    void printAttribution() {
+        if (!isAttributing()) return;
+        for (size_t layerIdx = 0; layerIdx < _contributions.size(); layerIdx++) {
+            if (_contributions[layerIdx].empty()) continue;
+
+            // Aggregate over stages, remembering the stage with the most clauses
+            FlatHashMap<int, Contribution> total;
+            FlatHashMap<int, std::pair<int, size_t>> mainStage;
+            for (const auto& [key, c] : _contributions[layerIdx]) {
+                int nameId = (int)(key >> 8);
+                int stage = (int)(key & 255) - 1;
+                auto& t = total[nameId];
+                t.numCls += c.numCls; t.numLits += c.numLits; t.time += c.time;
+                auto& m = mainStage[nameId];
+                if (c.numCls >= m.second) m = std::pair<int, size_t>(stage, c.numCls);
+            }
+
+            // Top contributors w.r.t. each of clauses, literals, and time
+            std::vector<std::pair<int, Contribution>> sorted;
+            for (const auto& [nameId, c] : total) sorted.emplace_back(nameId, c);
+            std::vector<int> top;
+            auto addTop = [&](auto greater) {
+                std::sort(sorted.begin(), sorted.end(), greater);
+                for (size_t i = 0; i < sorted.size() && i < _attribution_top_k; i++) {
+                    if (std::find(top.begin(), top.end(), sorted[i].first) == top.end()) 
+                        top.push_back(sorted[i].first);
+                }
+            };
+            addTop([](const auto& l, const auto& r) {return l.second.time > r.second.time;});
+            addTop([](const auto& l, const auto& r) {return l.second.numLits > r.second.numLits;});
+            addTop([](const auto& l, const auto& r) {return l.second.numCls > r.second.numCls;});
+            std::sort(top.begin(), top.end(), [&](int l, int r) {return total[l].numCls > total[r].numCls;});
+
+            Log::i("Top contributors at layer %i:\n", layerIdx);
+            for (int nameId : top) {
+                const auto& c = total[nameId];
+                Log::i("- %s : %lu cls, %lu lits, %.4fs (mostly %s)\n", 
+                        nameId < 0 ? "<none>" : TOSTR(nameId), c.numCls, c.numLits, c.time, 
+                        getStageName(mainStage[nameId].first));
+            }
+        }
+        _contributions.clear();
+    }
+
     ~EncodingStatistics() {
         printStages();
     }
+
+private:
+    static double now() {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void resetAttribution() {
+        _num_cls_at_attribution_start = _num_cls;
+        _num_lits_at_attribution_start = _num_lits;
+        _time_at_attribution_start = now();
+    }
+
+    void flushAttribution() {
+        double time = now();
+        int numCls = _num_cls - _num_cls_at_attribution_start;
+        int numLits = _num_lits - _num_lits_at_attribution_start;
+        if (numCls > 0 || numLits > 0 || _contributor >= 0) {
+            int stage = _current_stages.empty() ? -1 : _current_stages.back();
+            uint64_t key = ((uint64_t)(uint32_t)_contributor << 8) | (uint64_t)(stage+1);
+            if ((size_t)_layer_idx >= _contributions.size()) _contributions.resize(_layer_idx+1);
+            auto& c = _contributions[_layer_idx][key];
+            c.numCls += numCls;
+            c.numLits += numLits;
+            c.time += time - _time_at_attribution_start;
+        }
+        _num_cls_at_attribution_start = _num_cls;
+        _num_lits_at_attribution_start = _num_lits;
+        _time_at_attribution_start = time;
+    }
 };
 
 #endif
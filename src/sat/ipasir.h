@@ -125,5 +125,10 @@ void ipasir_set_phase (void * s, unsigned int v, bool phase);
  * Set the given variable to be a decision variable or not.
  */
 void ipasir_set_decision_var (void * s, unsigned int v, bool decision_var);
+/**
+ * Freeze (or melt) the given variable. A frozen variable is not eliminated 
+ * by preprocessing, e.g., because it will occur in assumptions. May be ignored.
+ */
+void ipasir_set_frozen (void * s, unsigned int v, bool frozen);
 
 #endif
@@ -0,0 +1,103 @@
+
+#include <dlfcn.h>
+#include <vector>
+#include <type_traits>
+
+#include "sat/ipasir_backend.h"
+#include "util/log.h"
+
+extern "C" {
+    #include "sat/ipasir.h"
+}
+
+IpasirBackend IpasirBackend::get(const std::string& nameOrPath) {
+    IpasirBackend backend = nameOrPath.empty() ? getLinked() : load(nameOrPath);
+    backend.printCapabilities();
+    return backend;
+}
+
+IpasirBackend IpasirBackend::getLinked() {
+    IpasirBackend b;
+    b.signature = ipasir_signature;
+    b.init = ipasir_init;
+    b.release = ipasir_release;
+    b.add = ipasir_add;
+    b.assume = ipasir_assume;
+    b.solve = ipasir_solve;
+    b.val = ipasir_val;
+    b.failed = ipasir_failed;
+    b.set_terminate = ipasir_set_terminate;
+    b.name = b.signature();
+
+    // The non-standard functions are always linked, but only the glues
+    // of glucose and cadical implement them (otherwise, they are dummies).
+    // Lingeling's ipasir_set_learn is a dummy as well.
+    bool glucose = b.name.rfind("glucose", 0) == 0;
+    bool cadical = b.name.rfind("cadical", 0) == 0;
+    if (b.name.rfind("lingeling", 0) != 0) b.set_learn = ipasir_set_learn;
+    if (glucose || cadical) {
+        b.set_seed = ipasir_set_seed;
+        b.set_phase = ipasir_set_phase;
+    }
+    if (glucose) b.set_decision_var = ipasir_set_decision_var;
+    if (cadical) b.set_frozen = ipasir_set_frozen;
+    return b;
+}
+
+IpasirBackend IpasirBackend::load(const std::string& nameOrPath) {
+    IpasirBackend b;
+
+    // A plain solver name is looked up in the library search path and in lib/<name>/
+    std::vector<std::string> candidates;
+    bool isPath = nameOrPath.find('/') != std::string::npos
+            || (nameOrPath.size() > 3 && nameOrPath.compare(nameOrPath.size()-3, 3, ".so") == 0);
+    if (isPath) candidates.push_back(nameOrPath);
+    else {
+        candidates.push_back("libipasir" + nameOrPath + ".so");
+        candidates.push_back("lib/" + nameOrPath + "/libipasir" + nameOrPath + ".so");
+    }
+    std::string error;
+    for (const auto& file : candidates) {
+        // Bind the library's symbols to its own definitions rather than
+        // to the IPASIR functions linked into this binary
+        b.handle = dlopen(file.c_str(), RTLD_NOW | RTLD_LOCAL | RTLD_DEEPBIND);
+        if (b.handle != nullptr) break;
+        error = dlerror();
+    }
+    if (b.handle == nullptr) {
+        Log::e("Could not load SAT solver library \"%s\": %s\n", nameOrPath.c_str(), error.c_str());
+        exit(1);
+    }
+
+    auto resolve = [&](auto& function, const char* symbol, bool required) {
+        function = reinterpret_cast<std::remove_reference_t<decltype(function)>>(dlsym(b.handle, symbol));
+        if (function == nullptr && required) {
+            Log::e("SAT solver library \"%s\" does not provide %s\n", nameOrPath.c_str(), symbol);
+            exit(1);
+        }
+    };
+    resolve(b.signature, "ipasir_signature", true);
+    resolve(b.init, "ipasir_init", true);
+    resolve(b.release, "ipasir_release", true);
+    resolve(b.add, "ipasir_add", true);
+    resolve(b.assume, "ipasir_assume", true);
+    resolve(b.solve, "ipasir_solve", true);
+    resolve(b.val, "ipasir_val", true);
+    resolve(b.failed, "ipasir_failed", true);
+    resolve(b.set_terminate, "ipasir_set_terminate", true);
+    resolve(b.set_learn, "ipasir_set_learn", false);
+    resolve(b.set_seed, "ipasir_set_seed", false);
+    resolve(b.set_phase, "ipasir_set_phase", false);
+    resolve(b.set_decision_var, "ipasir_set_decision_var", false);
+    resolve(b.set_frozen, "ipasir_set_frozen", false);
+    b.name = b.signature();
+    return b;
+}
+
+void IpasirBackend::printCapabilities() const {
+    auto yesNo = [](const void* function) {return function != nullptr ? "yes" : "no";};
+    Log::i("SAT solver: %s (%s) - learnt clauses: %s, seed: %s, phases: %s, decision vars: %s, frozen vars: %s\n",
+        name.c_str(), handle != nullptr ? "loaded" : "linked",
+        yesNo((const void*)set_learn), yesNo((const void*)set_seed), yesNo((const void*)set_phase),
+        yesNo((const void*)set_decision_var), yesNo((const void*)set_frozen));
+}
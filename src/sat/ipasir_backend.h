@@ -0,0 +1,45 @@
+
+#ifndef DOMPASCH_LILOTANE_IPASIR_BACKEND_H
+#define DOMPASCH_LILOTANE_IPASIR_BACKEND_H
+
+#include <string>
+
+/*
+The IPASIR functions of a SAT solver: either the ones linked into the binary
+or the ones of a shared library (libipasir<name>.so) loaded at runtime.
+Optional functions which are not supported by the solver are null.
+*/
+struct IpasirBackend {
+
+    std::string name;
+    void* handle = nullptr;
+
+    const char* (*signature)() = nullptr;
+    void* (*init)() = nullptr;
+    void (*release)(void*) = nullptr;
+    void (*add)(void*, int) = nullptr;
+    void (*assume)(void*, int) = nullptr;
+    int (*solve)(void*) = nullptr;
+    int (*val)(void*, int) = nullptr;
+    int (*failed)(void*, int) = nullptr;
+    void (*set_terminate)(void*, void*, int (*)(void*)) = nullptr;
+
+    // Optional functions
+    void (*set_learn)(void*, void*, int, void (*)(void*, int*)) = nullptr;
+    void (*set_seed)(void*, int) = nullptr;
+    void (*set_phase)(void*, unsigned int, bool) = nullptr;
+    void (*set_decision_var)(void*, unsigned int, bool) = nullptr;
+    void (*set_frozen)(void*, unsigned int, bool) = nullptr;
+
+    // Returns the backend linked into the binary if nameOrPath is empty,
+    // and the backend loaded from the according shared library otherwise.
+    static IpasirBackend get(const std::string& nameOrPath);
+
+    void printCapabilities() const;
+
+private:
+    static IpasirBackend getLinked();
+    static IpasirBackend load(const std::string& nameOrPath);
+};
+
+#endif
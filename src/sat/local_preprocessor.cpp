@@ -0,0 +1,138 @@
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "sat/local_preprocessor.h"
+
+void LocalPreprocessor::add(const std::vector<int>& cls) {
+    std::vector<int> sorted(cls);
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+    // Tautologies are always satisfied and can be dropped
+    for (int lit : sorted) if (lit > 0 && std::binary_search(sorted.begin(), sorted.end(), -lit)) return;
+    addClause(std::move(sorted));
+}
+
+size_t LocalPreprocessor::addClause(std::vector<int>&& cls) {
+    size_t idx = _clauses.size();
+    for (int lit : cls) _occurrences[lit].push_back(idx);
+    _clauses.push_back(std::move(cls));
+    _deleted.push_back(false);
+    _touched.push_back(false);
+    return idx;
+}
+
+void LocalPreprocessor::deleteClause(size_t idx) {
+    _deleted[idx] = true;
+}
+
+std::vector<size_t> LocalPreprocessor::getLiveOccurrences(int lit) {
+    std::vector<size_t> live;
+    auto it = _occurrences.find(lit);
+    if (it == _occurrences.end()) return live;
+    for (size_t idx : it->second) if (!_deleted[idx]) live.push_back(idx);
+    // Occurrence lists are cleaned up on the fly
+    it->second = live;
+    return live;
+}
+
+void LocalPreprocessor::process(const std::vector<int>& localVars) {
+
+    // Variable elimination, cheapest variables first
+    std::vector<std::pair<size_t, int>> candidates;
+    for (int var : localVars) {
+        size_t numPos = getLiveOccurrences(var).size();
+        size_t numNeg = getLiveOccurrences(-var).size();
+        candidates.emplace_back(numPos * numNeg, var);
+    }
+    std::sort(candidates.begin(), candidates.end());
+    FlatHashSet<int> remainingLocalVars;
+    for (const auto& [cost, var] : candidates) {
+        if (tryEliminate(var)) _num_eliminated_vars++;
+        else remainingLocalVars.insert(var);
+    }
+
+    // Subsumption of resolvents and of clauses with non-eliminated local variables
+    for (size_t idx = 0; idx < _clauses.size(); idx++) {
+        if (_deleted[idx]) continue;
+        bool check = _touched[idx];
+        if (!check) for (int lit : _clauses[idx]) if (remainingLocalVars.count(std::abs(lit))) {
+            check = true;
+            break;
+        }
+        if (check && isSubsumed(idx)) {
+            deleteClause(idx);
+            _num_subsumed_clauses++;
+        }
+    }
+}
+
+bool LocalPreprocessor::tryEliminate(int var) {
+
+    auto pos = getLiveOccurrences(var);
+    auto neg = getLiveOccurrences(-var);
+    if (pos.empty() && neg.empty()) return false;
+    if (pos.size() * neg.size() > MAX_OCCURRENCE_PRODUCT) return false;
+
+    // Compute all non-tautological resolvents; give up as soon as
+    // they outnumber the clauses they would replace
+    std::vector<std::vector<int>> resolvents;
+    size_t bound = pos.size() + neg.size();
+    std::vector<int> resolvent;
+    for (size_t p : pos) for (size_t n : neg) {
+        if (!resolve(_clauses[p], _clauses[n], var, resolvent)) continue;
+        if (resolvent.size() > MAX_RESOLVENT_LENGTH) return false;
+        resolvents.push_back(resolvent);
+        if (resolvents.size() > bound) return false;
+    }
+
+    // Replace the clauses containing the variable by the resolvents
+    for (size_t p : pos) deleteClause(p);
+    for (size_t n : neg) deleteClause(n);
+    for (auto& r : resolvents) {
+        size_t idx = addClause(std::move(r));
+        _touched[idx] = true;
+    }
+    return true;
+}
+
+bool LocalPreprocessor::resolve(const std::vector<int>& pos, const std::vector<int>& neg, int var,
+        std::vector<int>& resolvent) const {
+
+    resolvent.clear();
+    for (int lit : pos) if (lit != var) resolvent.push_back(lit);
+    for (int lit : neg) {
+        if (lit == -var) continue;
+        // Tautology?
+        if (std::binary_search(pos.begin(), pos.end(), -lit)) return false;
+        if (!std::binary_search(pos.begin(), pos.end(), lit)) resolvent.push_back(lit);
+    }
+    std::sort(resolvent.begin(), resolvent.end());
+    return true;
+}
+
+bool LocalPreprocessor::isSubsumed(size_t idx) {
+    const auto& cls = _clauses[idx];
+    size_t numChecks = 0;
+    for (int lit : cls) {
+        auto it = _occurrences.find(lit);
+        if (it == _occurrences.end()) continue;
+        for (size_t other : it->second) {
+            if (other == idx || _deleted[other]) continue;
+            const auto& otherCls = _clauses[other];
+            if (otherCls.size() > cls.size()) continue;
+            // Of two identical clauses, only the later one is removed
+            if (otherCls.size() == cls.size() && other > idx) continue;
+            if (std::includes(cls.begin(), cls.end(), otherCls.begin(), otherCls.end())) return true;
+            if (++numChecks >= MAX_SUBSUMPTION_CHECKS) return false;
+        }
+    }
+    return false;
+}
+
+void LocalPreprocessor::clear() {
+    _clauses.clear();
+    _deleted.clear();
+    _touched.clear();
+    _occurrences.clear();
+}
@@ -0,0 +1,60 @@
+
+#ifndef DOMPASCH_LILOTANE_LOCAL_PREPROCESSOR_H
+#define DOMPASCH_LILOTANE_LOCAL_PREPROCESSOR_H
+
+#include <vector>
+#include <stddef.h>
+
+#include "util/hashmap.h"
+
+/*
+Bounded variable elimination and subsumption over a batch of clauses.
+Only variables which are local to the batch, i.e., which cannot occur in any clause
+or assumption added later, may be eliminated. Only clauses which were produced
+by elimination or which still contain a local variable are checked for subsumption.
+*/
+class LocalPreprocessor {
+
+private:
+    std::vector<std::vector<int>> _clauses;
+    std::vector<bool> _deleted;
+    std::vector<bool> _touched;
+    // literal -> indices of clauses containing it (may include deleted clauses)
+    FlatHashMap<int, std::vector<size_t>> _occurrences;
+
+    size_t _num_eliminated_vars = 0;
+    size_t _num_subsumed_clauses = 0;
+
+public:
+    static const size_t MAX_RESOLVENT_LENGTH = 16;
+    static const size_t MAX_OCCURRENCE_PRODUCT = 1024;
+    static const size_t MAX_SUBSUMPTION_CHECKS = 1024;
+
+    void add(const std::vector<int>& cls);
+
+    // Eliminates each of the provided local variables if this does not increase
+    // the number of clauses, then removes touched clauses subsumed by other clauses.
+    void process(const std::vector<int>& localVars);
+
+    template <typename F>
+    void forEachClause(F f) const {
+        for (size_t i = 0; i < _clauses.size(); i++) if (!_deleted[i]) f(_clauses[i]);
+    }
+
+    size_t size() const {return _clauses.size();}
+    bool empty() const {return _clauses.empty();}
+    void clear();
+
+    size_t getNumEliminatedVars() const {return _num_eliminated_vars;}
+    size_t getNumSubsumedClauses() const {return _num_subsumed_clauses;}
+
+private:
+    size_t addClause(std::vector<int>&& cls);
+    void deleteClause(size_t idx);
+    std::vector<size_t> getLiveOccurrences(int lit);
+    bool tryEliminate(int var);
+    bool resolve(const std::vector<int>& pos, const std::vector<int>& neg, int var, std::vector<int>& resolvent) const;
+    bool isSubsumed(size_t idx);
+};
+
+#endif
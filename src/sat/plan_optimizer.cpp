@@ -10,6 +10,11 @@ void PlanOptimizer::optimizePlan(int upperBound, Plan& plan, ConstraintAddition
 
     // Add counting mechanism
     _stats.begin(STAGE_PLANLENGTHCOUNTING);
+    // Transient counting constraints are guarded by a clause group 
+    // which is retired as soon as the optimization is done
+    int group = 0;
+    if (mode == ConstraintAddition::TRANSIENT) 
+        group = _sat.openGroup("plan length counting at layer " + std::to_string(layerIdx));
     int minPlanLength = 0;
     int maxPlanLength = 0;
     std::vector<int> planLengthVars(1, VariableDomain::nextVar());
@@ -151,6 +156,11 @@ void PlanOptimizer::optimizePlan(int upperBound, Plan& plan, ConstraintAddition
             layerIdx, l.size()-1, minPlanLength, maxPlanLength);
     assert((int)planLengthVars.size() == maxPlanLength-minPlanLength+1 || Log::e("%i != %i-%i+1\n", planLengthVars.size(), maxPlanLength, minPlanLength));
     
+    if (group != 0) {
+        _sat.closeGroup();
+        _sat.enableGroup(group);
+    }
+
     // Add primitiveness of all positions at the final layer
     // as unit literals (instead of assumptions)
     _enc.addAssumptions(layerIdx, /*permanent=*/mode == ConstraintAddition::PERMANENT);
@@ -172,6 +182,7 @@ void PlanOptimizer::optimizePlan(int upperBound, Plan& plan, ConstraintAddition
             curr = newPlanLength;
             return newPlanLength;
         }, mode);
+    if (group != 0) _sat.retireGroup(group);
 
     float factor = (float)currentPlanLength / minPlanLength;
     if (factor <= 1) {
@@ -8,20 +8,24 @@
 #include <iostream>
 #include <assert.h>
 #include <vector>
+#include <algorithm>
+#include <cstdlib>
 
 #include "util/params.h"
 #include "util/log.h"
+#include "util/hashmap.h"
+#include "util/bitset.h"
 #include "sat/variable_domain.h"
 #include "sat/encoding_statistics.h"
+#include "sat/local_preprocessor.h"
 
-extern "C" {
-    #include "sat/ipasir.h"
-}
+#include "sat/ipasir_backend.h"
 
 class SatInterface {
 
 private:
     Parameters& _params;
+    IpasirBackend _api;
     void* _solver;
     std::ofstream _out;
     EncodingStatistics& _stats;
@@ -30,129 +34,312 @@ private:
     bool _began_line = false;
 
     std::vector<int> _last_assumptions;
-    std::vector<int> _no_decision_variables;
+
+    // Clause which is currently being added
+    std::vector<int> _clause;
+
+    // Encoder-side simplification: values of variables fixed by unit clauses (1, -1, or 0 if unknown)
+    const bool _propagate_units;
+    std::vector<int8_t> _unit_values;
+    // Variables which occurred in some clause or assumption passed to the solver
+    Bitset _sent_vars;
+    size_t _num_dropped_clauses = 0;
+    size_t _num_stripped_literals = 0;
+
+    // Clauses held back for preprocessing w.r.t. local variables
+    bool _batching = false;
+    LocalPreprocessor _batch;
+    size_t _num_batched_lits = 0;
+
+    // Clause groups: activation literal of the currently open group (0 if none),
+    // the groups currently enabled, and the names of all live groups
+    int _open_group = 0;
+    std::vector<int> _enabled_groups;
+    FlatHashMap<int, std::string> _group_names;
+    size_t _num_retired_groups = 0;
 
 public:
     SatInterface(Parameters& params, EncodingStatistics& stats) : 
-                _params(params), _stats(stats), _print_formula(params.isNonzero("wf")) {
-        _solver = ipasir_init();
-        ipasir_set_seed(_solver, params.getIntParam("s"));
+                _params(params), _api(IpasirBackend::get(params.getParam("solver", ""))),
+                _stats(stats), _print_formula(params.isNonzero("wf")),
+                _propagate_units(params.isNonzero("eup")) {
+        _solver = _api.init();
+        if (_api.set_seed) _api.set_seed(_solver, params.getIntParam("s"));
         if (_print_formula) _out.open("formula.cnf");
     }
     
     inline void addClause(int lit) {
         assert(lit != 0);
-        ipasir_add(_solver, lit); ipasir_add(_solver, 0);
-        if (_print_formula) _out << lit << " 0\n";
-        _stats._num_lits++; _stats._num_cls++;
+        _clause.push_back(lit);
+        flushClause();
     }
     inline void addClause(int lit1, int lit2) {
         assert(lit1 != 0);
         assert(lit2 != 0);
-        ipasir_add(_solver, lit1); ipasir_add(_solver, lit2); ipasir_add(_solver, 0);
-        if (_print_formula) _out << lit1 << " " << lit2 << " 0\n";
-        _stats._num_lits += 2; _stats._num_cls++;
+        _clause.push_back(lit1); _clause.push_back(lit2);
+        flushClause();
     }
     inline void addClause(int lit1, int lit2, int lit3) {
         assert(lit1 != 0);
         assert(lit2 != 0);
         assert(lit3 != 0);
-        ipasir_add(_solver, lit1); ipasir_add(_solver, lit2); ipasir_add(_solver, lit3); ipasir_add(_solver, 0);
-        if (_print_formula) _out << lit1 << " " << lit2 << " " << lit3 << " 0\n";
-        _stats._num_lits += 3; _stats._num_cls++;
+        _clause.push_back(lit1); _clause.push_back(lit2); _clause.push_back(lit3);
+        flushClause();
     }
     inline void addClause(const std::initializer_list<int>& lits) {
         for (int lit : lits) {
             assert(lit != 0);
-            ipasir_add(_solver, lit);
-            if (_print_formula) _out << lit << " ";
+            _clause.push_back(lit);
         } 
-        ipasir_add(_solver, 0);
-        if (_print_formula) _out << "0\n";
-        _stats._num_cls++;
-        _stats._num_lits += lits.size();
+        flushClause();
     }
     inline void addClause(const std::vector<int>& cls) {
         for (int lit : cls) {
             assert(lit != 0);
-            ipasir_add(_solver, lit);
-            if (_print_formula) _out << lit << " ";
+            _clause.push_back(lit);
         } 
-        ipasir_add(_solver, 0);
-        if (_print_formula) _out << "0\n";
-        _stats._num_cls++;
-        _stats._num_lits += cls.size();
+        flushClause();
     }
     inline void appendClause(int lit) {
         _began_line = true;
         assert(lit != 0);
-        ipasir_add(_solver, lit);
-        if (_print_formula) _out << lit << " ";
-        _stats._num_lits++;
+        _clause.push_back(lit);
     }
     inline void appendClause(int lit1, int lit2) {
         _began_line = true;
         assert(lit1 != 0);
         assert(lit2 != 0);
-        ipasir_add(_solver, lit1); ipasir_add(_solver, lit2);
-        if (_print_formula) _out << lit1 << " " << lit2 << " ";
-        _stats._num_lits += 2;
+        _clause.push_back(lit1); _clause.push_back(lit2);
     }
     inline void appendClause(const std::initializer_list<int>& lits) {
         _began_line = true;
         for (int lit : lits) {
             assert(lit != 0);
-            ipasir_add(_solver, lit);
-            if (_print_formula) _out << lit << " ";
-            //log("%i ", lit);
+            _clause.push_back(lit);
         } 
-
-        _stats._num_lits += lits.size();
     }
     inline void endClause() {
         assert(_began_line);
-        ipasir_add(_solver, 0);
-        if (_print_formula) _out << "0\n";
-        //log("0\n");
+        flushClause();
         _began_line = false;
-
-        _stats._num_cls++;
     }
     inline void assume(int lit) {
         if (_stats._num_asmpts == 0) _last_assumptions.clear();
-        ipasir_assume(_solver, lit);
+        markSent(lit);
+        _api.assume(_solver, lit);
         //log("CNF !%i\n", lit);
         _last_assumptions.push_back(lit);
         _stats._num_asmpts++;
     }
 
+    // Opens a clause group: all clauses added until closeGroup() are guarded 
+    // by the returned activation literal and only apply while the group is enabled.
+    int openGroup(const std::string& name) {
+        assert(_open_group == 0);
+        _open_group = VariableDomain::nextVar();
+        setFrozen(_open_group, true);
+        _group_names[_open_group] = name;
+        Log::d("Opened clause group \"%s\" (activation literal %i)\n", name.c_str(), _open_group);
+        return _open_group;
+    }
+    void closeGroup() {
+        assert(_open_group != 0);
+        _open_group = 0;
+    }
+    // Enables the group for all subsequent solver calls (via assumptions)
+    void enableGroup(int group) {
+        assert(_group_names.count(group));
+        if (std::find(_enabled_groups.begin(), _enabled_groups.end(), group) == _enabled_groups.end())
+            _enabled_groups.push_back(group);
+    }
+    void disableGroup(int group) {
+        auto it = std::find(_enabled_groups.begin(), _enabled_groups.end(), group);
+        if (it != _enabled_groups.end()) _enabled_groups.erase(it);
+    }
+    // Permanently discards the group: its clauses become satisfied
+    // and can be garbage-collected by the solver.
+    void retireGroup(int group) {
+        assert(group != _open_group);
+        disableGroup(group);
+        int openGroup = _open_group;
+        _open_group = 0;
+        addClause(-group);
+        setFrozen(group, false);
+        _open_group = openGroup;
+        Log::v("Retired clause group \"%s\"\n", _group_names[group].c_str());
+        _group_names.erase(group);
+        _num_retired_groups++;
+    }
+    size_t getNumRetiredGroups() const {return _num_retired_groups;}
+
     inline bool holds(int lit) {
-        return ipasir_val(_solver, lit) > 0;
+        // Variables which only occurred in dropped clauses are unknown to the solver
+        if (!isSent(lit)) return getUnitValue(lit) > 0;
+        return _api.val(_solver, lit) > 0;
     }
 
     inline bool didAssumptionFail(int lit) {
-        return ipasir_failed(_solver, lit);
+        return _api.failed(_solver, lit);
     }
 
     bool hasLastAssumptions() {
         return !_last_assumptions.empty();
     }
 
+    bool supportsPhases() const {
+        return _api.set_phase != nullptr;
+    }
+    inline void setPhase(int var, bool phase) {
+        if (_api.set_phase) _api.set_phase(_solver, var, phase);
+    }
+
+    inline void setDecisionVar(int var, bool decision) {
+        if (_api.set_decision_var) _api.set_decision_var(_solver, var, decision);
+    }
+    inline void setFrozen(int var, bool frozen) {
+        if (_api.set_frozen) _api.set_frozen(_solver, var, frozen);
+    }
+
     void setTerminateCallback(void * state, int (*terminate)(void * state)) {
-        ipasir_set_terminate(_solver, state, terminate);
+        _api.set_terminate(_solver, state, terminate);
     }
 
+    bool supportsLearnCallback() const {
+        return _api.set_learn != nullptr;
+    }
     void setLearnCallback(int maxLength, void* state, void (*learn)(void * state, int * clause)) {
-        ipasir_set_learn(_solver, state, maxLength, learn);
+        if (_api.set_learn) _api.set_learn(_solver, state, maxLength, learn);
     }
 
     int solve() {
-        int result = ipasir_solve(_solver);
+        assumeEnabledGroups();
+        int result = _api.solve(_solver);
+        if (_stats._num_asmpts == 0) _last_assumptions.clear();
+        _stats._num_asmpts = 0;
+        return result;
+    }
+
+    // Solves under the added assumptions and the additional hint literals. 
+    // If this is unsatisfiable, solves again under the added assumptions only.
+    int solveWithHints(const std::vector<int>& hints) {
+        assumeEnabledGroups();
+        for (int lit : hints) _api.assume(_solver, lit);
         if (_stats._num_asmpts == 0) _last_assumptions.clear();
+        int result = _api.solve(_solver);
+        if (result == 20) {
+            Log::v("Unsatisfiable under hints - solving again without hints\n");
+            for (int lit : _last_assumptions) _api.assume(_solver, lit);
+            result = _api.solve(_solver);
+        }
         _stats._num_asmpts = 0;
         return result;
     }
 
+    // Holds back all subsequently added clauses until endBatch() is called.
+    void beginBatch() {
+        assert(!_batching && _open_group == 0);
+        _batching = true;
+    }
+    // Preprocesses the held back clauses, eliminating local variables where possible, 
+    // and passes the remaining clauses to the solver. 
+    // Returns the number of clauses held back and the number of clauses passed on.
+    std::pair<size_t, size_t> endBatch(const std::vector<int>& localVars) {
+        assert(_batching);
+        _batching = false;
+        size_t numBatched = _batch.size();
+        if (!localVars.empty()) _batch.process(localVars);
+        size_t numPassed = 0;
+        _batch.forEachClause([&](const std::vector<int>& cls) {
+            sendClause(cls);
+            numPassed++;
+            _stats._num_lits += cls.size();
+        });
+        // Clauses and literals were counted when they were held back
+        _stats._num_cls += numPassed;
+        _stats._num_cls -= numBatched;
+        _stats._num_lits -= _num_batched_lits;
+        _num_batched_lits = 0;
+        _batch.clear();
+        return std::pair<size_t, size_t>(numBatched, numPassed);
+    }
+    size_t getNumEliminatedVars() const {return _batch.getNumEliminatedVars();}
+    size_t getNumSubsumedClauses() const {return _batch.getNumSubsumedClauses();}
+
+    size_t getNumDroppedClauses() const {return _num_dropped_clauses;}
+    size_t getNumStrippedLiterals() const {return _num_stripped_literals;}
+
+private:
+    inline void flushClause() {
+        if (_open_group != 0) _clause.push_back(-_open_group);
+        if (_propagate_units && !simplifyClause()) {
+            _clause.clear();
+            return;
+        }
+        _stats._num_cls++;
+        _stats._num_lits += _clause.size();
+        if (_batching) {
+            _batch.add(_clause);
+            _num_batched_lits += _clause.size();
+        } else sendClause(_clause);
+        _clause.clear();
+    }
+
+    inline void sendClause(const std::vector<int>& cls) {
+        for (int lit : cls) {
+            markSent(lit);
+            _api.add(_solver, lit);
+            if (_print_formula) _out << lit << " ";
+        }
+        _api.add(_solver, 0);
+        if (_print_formula) _out << "0\n";
+    }
+
+    inline void markSent(int lit) {
+        size_t var = std::abs(lit);
+        _sent_vars.grow(var+1);
+        _sent_vars.set(var);
+    }
+    inline bool isSent(int lit) const {
+        size_t var = std::abs(lit);
+        return var < _sent_vars.size() && _sent_vars.test(var);
+    }
+
+    inline int getUnitValue(int lit) const {
+        size_t var = std::abs(lit);
+        if (var >= _unit_values.size()) return 0;
+        return lit > 0 ? _unit_values[var] : -_unit_values[var];
+    }
+
+    // Removes the literals of the current clause which are known to be false
+    // and records the remaining literal if the clause becomes a unit.
+    // Returns false if the clause is already satisfied by a known unit.
+    inline bool simplifyClause() {
+        size_t size = 0;
+        for (int lit : _clause) {
+            int value = getUnitValue(lit);
+            if (value > 0) {
+                _num_dropped_clauses++;
+                return false;
+            }
+            if (value == 0) _clause[size++] = lit;
+        }
+        // All literals are false: add the clause unchanged (the formula is unsatisfiable)
+        if (size == 0) return true;
+        _num_stripped_literals += _clause.size() - size;
+        _clause.resize(size);
+        if (size == 1) {
+            size_t var = std::abs(_clause[0]);
+            if (var >= _unit_values.size()) _unit_values.resize(std::max(var+1, 2*_unit_values.size()), 0);
+            _unit_values[var] = _clause[0] > 0 ? 1 : -1;
+        }
+        return true;
+    }
+
+    void assumeEnabledGroups() {
+        for (int group : _enabled_groups) assume(group);
+    }
+
+public:
     ~SatInterface() {
         
         if (_params.isNonzero("wf")) {
@@ -187,7 +374,7 @@ public:
         }
 
         // Release SAT solver
-        ipasir_release(_solver);
+        _api.release(_solver);
     }
 };
 
@@ -0,0 +1,64 @@
+
+#include <algorithm>
+
+#include "sat/sat_profiler.h"
+#include "util/log.h"
+#include "util/names.h"
+
+void SatProfiler::onLearntClause(const int* cls) {
+    _num_learnt_clauses++;
+    int maxLayer = -1;
+    for (size_t i = 0; cls[i] != 0; i++) {
+        VarInfo info = VariableDomain::getInfo(std::abs(cls[i]));
+        _num_learnt_lits++;
+        _learnt_lits_by_kind[info.kind]++;
+        _learnt_lits_by_stage[info.stage+1]++;
+        if (info.kind == VAR_OP) _learnt_lits_by_op[info.nameId]++;
+        if (info.kind == VAR_FACT) _learnt_lits_by_predicate[info.nameId]++;
+        maxLayer = std::max(maxLayer, info.layerIdx);
+    }
+    if (maxLayer >= 0) {
+        if ((size_t)maxLayer >= _learnt_clauses_by_layer.size()) _learnt_clauses_by_layer.resize(maxLayer+1, 0);
+        _learnt_clauses_by_layer[maxLayer]++;
+    }
+}
+
+void SatProfiler::onFailedAssumption(const std::vector<int>& opNameIds) {
+    _num_failed_assumptions++;
+    for (int nameId : opNameIds) _failed_assumptions_by_op[nameId]++;
+}
+
+static void printTopContributors(const char* title, const FlatHashMap<int, size_t>& counts, size_t total, size_t limit) {
+    std::vector<std::pair<size_t, int>> sorted;
+    for (const auto& [nameId, count] : counts) sorted.emplace_back(count, nameId);
+    std::sort(sorted.begin(), sorted.end(), std::greater<std::pair<size_t, int>>());
+    Log::i("%s:\n", title);
+    for (size_t i = 0; i < sorted.size() && i < limit; i++) {
+        Log::i("- %s : %i (%.1f%%)\n", Names::to_string(sorted[i].second).c_str(), sorted[i].first, 
+                100.0 * sorted[i].first / std::max(total, (size_t)1));
+    }
+}
+
+void SatProfiler::printReport(size_t numTopContributors) const {
+    Log::i("SAT profile: %i learnt clauses (%i literals), %i failed assumptions\n", 
+            _num_learnt_clauses, _num_learnt_lits, _num_failed_assumptions);
+    if (_num_learnt_clauses == 0 && _num_failed_assumptions == 0) return;
+
+    Log::i("Learnt literals by kind of variable:\n");
+    for (int kind = 0; kind <= VAR_AUX; kind++) {
+        if (_learnt_lits_by_kind[kind] > 0) 
+            Log::i("- %s : %i\n", VariableDomain::getKindName(VarKind(kind)), _learnt_lits_by_kind[kind]);
+    }
+    Log::i("Learnt literals by encoding stage of variable:\n");
+    for (size_t stage = 0; stage < _learnt_lits_by_stage.size(); stage++) {
+        if (_learnt_lits_by_stage[stage] > 0) 
+            Log::i("- %s : %i\n", _stats.getStageName((int)stage-1), _learnt_lits_by_stage[stage]);
+    }
+    Log::i("Learnt clauses by (deepest) layer:\n");
+    for (size_t layer = 0; layer < _learnt_clauses_by_layer.size(); layer++) {
+        Log::i("- %i : %i\n", layer, _learnt_clauses_by_layer[layer]);
+    }
+    printTopContributors("Learnt literals by operation", _learnt_lits_by_op, _num_learnt_lits, numTopContributors);
+    printTopContributors("Learnt literals by predicate", _learnt_lits_by_predicate, _num_learnt_lits, numTopContributors);
+    printTopContributors("Failed assumptions by operation", _failed_assumptions_by_op, _num_failed_assumptions, numTopContributors);
+}
@@ -0,0 +1,44 @@
+
+#ifndef DOMPASCH_LILOTANE_SAT_PROFILER_H
+#define DOMPASCH_LILOTANE_SAT_PROFILER_H
+
+#include <vector>
+
+#include "util/hashmap.h"
+#include "sat/variable_domain.h"
+#include "sat/encoding_statistics.h"
+
+/*
+Attributes the work of the SAT solver to the parts of the encoding it concerns:
+the literals of learnt clauses (one clause is learnt per conflict) and the failed 
+assumptions are counted per lifted operation / predicate, per kind of variable,
+per encoding stage and per layer, based on the variable metadata of VariableDomain.
+*/
+class SatProfiler {
+
+private:
+    EncodingStatistics& _stats;
+
+    size_t _num_learnt_clauses = 0;
+    size_t _num_learnt_lits = 0;
+    size_t _num_failed_assumptions = 0;
+
+    FlatHashMap<int, size_t> _learnt_lits_by_op;
+    FlatHashMap<int, size_t> _learnt_lits_by_predicate;
+    std::vector<size_t> _learnt_lits_by_kind;
+    std::vector<size_t> _learnt_lits_by_stage;
+    std::vector<size_t> _learnt_clauses_by_layer;
+    FlatHashMap<int, size_t> _failed_assumptions_by_op;
+
+public:
+    SatProfiler(EncodingStatistics& stats) : _stats(stats), 
+            _learnt_lits_by_kind(VAR_AUX+1, 0), _learnt_lits_by_stage(stats.getNumStages()+1, 0) {}
+
+    void onLearntClause(const int* cls);
+    // The primitiveness assumption of a position failed: count each operation at the position
+    void onFailedAssumption(const std::vector<int>& opNameIds);
+
+    void printReport(size_t numTopContributors = 10) const;
+};
+
+#endif
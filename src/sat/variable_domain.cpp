@@ -1,4 +1,7 @@
 
+#include <algorithm>
+#include <assert.h>
+
 #include "variable_domain.h"
 
 #include "util/log.h"
@@ -7,18 +10,62 @@
 int VariableDomain::_running_var_id = 1;
 bool VariableDomain::_locked = false;
 bool VariableDomain::_print_variables = false;
+std::vector<VariableDomain::VarRange> VariableDomain::_ranges;
+std::vector<int> VariableDomain::_name_ids;
+int VariableDomain::_context_layer_idx = -1;
+int VariableDomain::_context_pos = -1;
+int VariableDomain::_context_stage = -1;
 
 void VariableDomain::init(const Parameters& params) {
     _print_variables = params.isNonzero("pvn");
 }
 
 int VariableDomain::nextVar() {
-    return _running_var_id++;
+    return nextVar(VAR_AUX, _context_layer_idx, _context_pos, -1);
+}
+int VariableDomain::nextVar(VarKind kind, int layerIdx, int pos, int nameId) {
+    int var = _running_var_id++;
+    if (_ranges.empty() || _ranges.back().kind != kind || _ranges.back().layerIdx != layerIdx 
+            || _ranges.back().pos != pos || _ranges.back().stage != _context_stage) {
+        _ranges.push_back(VarRange{var, layerIdx, pos, _context_stage, kind});
+    }
+    _name_ids.push_back(nameId);
+    return var;
 }
 int VariableDomain::getMaxVar() {
     return _running_var_id-1;
 }
 
+void VariableDomain::setContext(int layerIdx, int pos) {
+    _context_layer_idx = layerIdx;
+    _context_pos = pos;
+}
+void VariableDomain::setStage(int stage) {
+    _context_stage = stage;
+}
+
+VarInfo VariableDomain::getInfo(int var) {
+    assert(var > 0 && var < _running_var_id);
+    auto it = std::upper_bound(_ranges.begin(), _ranges.end(), var, 
+            [](int v, const VarRange& range) {return v < range.firstVar;});
+    const VarRange& range = *(--it);
+    return VarInfo{range.kind, range.layerIdx, range.pos, range.stage, _name_ids[var-1]};
+}
+
+const char* VariableDomain::getKindName(VarKind kind) {
+    switch (kind) {
+    case VAR_OP: return "op";
+    case VAR_FACT: return "fact";
+    case VAR_SUBSTITUTION: return "substitution";
+    case VAR_QEQUALITY: return "qconstequality";
+    default: return "aux";
+    }
+}
+
+size_t VariableDomain::getMetadataMemoryUsage() {
+    return _ranges.capacity() * sizeof(VarRange) + _name_ids.capacity() * sizeof(int);
+}
+
 void VariableDomain::printVar(int var, int layerIdx, int pos, const USignature& sig) {
     if (_print_variables) {
         Log::d("VARMAP %i %s\n", var, varName(layerIdx, pos, sig).c_str());
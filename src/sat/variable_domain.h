@@ -2,9 +2,30 @@
 #ifndef DOMPASCH_TREE_REXX_VARIABLE_DOMAIN_H
 #define DOMPASCH_TREE_REXX_VARIABLE_DOMAIN_H
 
+#include <vector>
+
 #include "util/params.h"
 #include "data/signature.h"
 
+enum VarKind : uint8_t {VAR_OP, VAR_FACT, VAR_SUBSTITUTION, VAR_QEQUALITY, VAR_AUX};
+
+// How the solver should treat a variable: decision variables are branched on,
+// auxiliary variables are determined by other variables and need no branching,
+// and interface variables are auxiliary variables which also occur in assumptions
+// and thus must not be eliminated.
+enum VarRole : uint8_t {ROLE_DECISION, ROLE_AUXILIARY, ROLE_INTERFACE};
+
+// What a variable stands for: its kind, the position and encoding stage 
+// during which it was introduced, and the name ID of its operation / predicate 
+// (resp. q-constant for substitution variables; -1 for auxiliary variables)
+struct VarInfo {
+    VarKind kind;
+    int layerIdx;
+    int pos;
+    int stage;
+    int nameId;
+};
+
 class VariableDomain {
 
 private:
@@ -13,12 +34,37 @@ private:
 
     static bool _print_variables;
 
+    // Metadata of all variables: consecutive variables with the same kind, position 
+    // and stage share a range, and only the name ID is stored for each variable.
+    struct VarRange {
+        int firstVar;
+        int layerIdx;
+        int pos;
+        int stage;
+        VarKind kind;
+    };
+    static std::vector<VarRange> _ranges;
+    static std::vector<int> _name_ids;
+
+    // Context in which auxiliary variables are introduced
+    static int _context_layer_idx;
+    static int _context_pos;
+    static int _context_stage;
+
 public:
     static void init(const Parameters& params);
 
+    // Introduces an auxiliary variable at the current context.
     static int nextVar();
+    static int nextVar(VarKind kind, int layerIdx, int pos, int nameId);
     static int getMaxVar();
 
+    static void setContext(int layerIdx, int pos);
+    static void setStage(int stage);
+    static VarInfo getInfo(int var);
+    static const char* getKindName(VarKind kind);
+    static size_t getMetadataMemoryUsage();
+
     static void printVar(int var, int layerIdx, int pos, const USignature& sig);
     static std::string varName(int layerIdx, int pos, const USignature& sig);
     
@@ -27,4 +73,4 @@ public:
     static void unlock();
 };
 
-#endif
\ No newline at end of file
+#endif
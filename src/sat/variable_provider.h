@@ -65,10 +65,9 @@ public:
         int var;
         if (!_substitution_variables.count(sigSubst)) {
             assert(!VariableDomain::isLocked() || Log::e("Unknown substitution variable %s queried!\n", TOSTR(sigSubst)));
-            var = VariableDomain::nextVar();
+            var = VariableDomain::nextVar(VAR_SUBSTITUTION, -1, -1, qConstId);
             _substitution_variables[sigSubst] = var;
             VariableDomain::printVar(var, -1, -1, sigSubst);
-            //_no_decision_variables.push_back(var);
         } else var = _substitution_variables[sigSubst];
         return var;
     }
@@ -84,7 +83,7 @@ public:
         return _q_equality_variables.count(IntPair(qconst1, qconst2));
     }
     int encodeQConstantEqualityVar(int qconst1, int qconst2) {
-        int var = VariableDomain::nextVar();
+        int var = VariableDomain::nextVar(VAR_QEQUALITY, -1, -1, qconst1);
         _q_equality_variables[IntPair(qconst1, qconst2)] = var;
         return var;
     }
@@ -92,6 +91,15 @@ public:
         return _q_equality_variables[IntPair(qconst1, qconst2)];
     }
 
+    VarRole getRole(int var) {
+        VarInfo info = VariableDomain::getInfo(var);
+        // Binary AMO digits, plan length counters, clause group activation literals, ...
+        if (info.kind == VAR_AUX) return ROLE_AUXILIARY;
+        // Primitiveness is defined by the operations and assumed at the final layer
+        if (info.kind == VAR_OP && info.nameId == _sig_primitive._name_id) return ROLE_INTERFACE;
+        return ROLE_DECISION;
+    }
+
     void skipVariable() {
         VariableDomain::nextVar();
     }
@@ -0,0 +1,134 @@
+
+#include <random>
+#include <algorithm>
+#include <assert.h>
+
+#include "util/timer.h"
+#include "util/log.h"
+#include "util/params.h"
+#include "util/bitset.h"
+
+typedef std::vector<bool> Reference;
+
+bool equals(const Bitset& b, const Reference& r) {
+    if (b.size() != r.size()) return false;
+    size_t count = 0;
+    for (size_t i = 0; i < r.size(); i++) {
+        if (b.test(i) != r[i]) return false;
+        if (r[i]) count++;
+    }
+    // Bits beyond the size are never reported
+    if (b.test(r.size()) || b.test(r.size()+64)) return false;
+    std::vector<size_t> visited;
+    b.forEach([&](size_t i) {visited.push_back(i);});
+    if (visited.size() != count || !std::is_sorted(visited.begin(), visited.end())) return false;
+    for (size_t i : visited) if (!r[i]) return false;
+    return b.count() == count && b.any() == (count > 0);
+}
+
+Reference randomReference(std::mt19937& rng, size_t size) {
+    Reference r(size);
+    for (size_t i = 0; i < size; i++) r[i] = rng() % 3 == 0;
+    return r;
+}
+
+Bitset toBitset(const Reference& r) {
+    Bitset b(r.size());
+    for (size_t i = 0; i < r.size(); i++) b.set(i, r[i]);
+    return b;
+}
+
+int main(int argc, char** argv) {
+
+    Timer::init();
+
+    Parameters params;
+    params.init(argc, argv);
+
+    int verbosity = params.getIntParam("v");
+    Log::init(verbosity, /*coloredOutput=*/params.isNonzero("co"));
+
+    std::mt19937 rng(1);
+    // Sizes around word boundaries
+    std::vector<size_t> sizes{0, 1, 63, 64, 65, 127, 128, 129, 1000};
+
+    // Single bit operations
+    for (size_t size : sizes) {
+        Bitset b(size);
+        Reference r(size);
+        assert(equals(b, r));
+        for (int op = 0; op < 1000 && size > 0; op++) {
+            size_t i = rng() % size;
+            switch (rng() % 3) {
+            case 0: b.set(i); r[i] = true; break;
+            case 1: b.reset(i); r[i] = false; break;
+            case 2: {bool v = rng() % 2; b.set(i, v); r[i] = v; break;}
+            }
+        }
+        assert(equals(b, r));
+
+        b.fill();
+        assert(equals(b, Reference(size, true)));
+        b.clear();
+        assert(equals(b, Reference(size, false)));
+    }
+
+    // Resizing keeps the bits below the new size and clears the others
+    for (size_t size : sizes) for (size_t newSize : sizes) {
+        Reference r = randomReference(rng, size);
+        Bitset b = toBitset(r);
+        b.resize(newSize);
+        r.resize(newSize, false);
+        assert(equals(b, r));
+        // Bits cut off by shrinking do not reappear when growing again
+        b.grow(1000);
+        r.resize(std::max(newSize, (size_t)1000), false);
+        assert(equals(b, r));
+    }
+
+    // Set operations, also between bitsets of different sizes
+    for (size_t sizeA : sizes) for (size_t sizeB : sizes) {
+        Reference ra = randomReference(rng, sizeA);
+        Reference rb = randomReference(rng, sizeB);
+        Bitset a = toBitset(ra);
+        Bitset b = toBitset(rb);
+        auto bitOf = [](const Reference& r, size_t i) {return i < r.size() && r[i];};
+
+        Bitset x = toBitset(ra);
+        x &= b;
+        Reference rAnd(sizeA);
+        for (size_t i = 0; i < sizeA; i++) rAnd[i] = ra[i] && bitOf(rb, i);
+        assert(equals(x, rAnd));
+
+        x = toBitset(ra);
+        x |= b;
+        Reference rOr(std::max(sizeA, sizeB));
+        for (size_t i = 0; i < rOr.size(); i++) rOr[i] = bitOf(ra, i) || bitOf(rb, i);
+        assert(equals(x, rOr));
+
+        x = toBitset(ra);
+        x.subtract(b);
+        Reference rMinus(sizeA);
+        for (size_t i = 0; i < sizeA; i++) rMinus[i] = ra[i] && !bitOf(rb, i);
+        assert(equals(x, rMinus));
+
+        size_t numCommon = 0;
+        bool subset = true;
+        for (size_t i = 0; i < sizeA; i++) {
+            if (ra[i] && bitOf(rb, i)) numCommon++;
+            if (ra[i] && !bitOf(rb, i)) subset = false;
+        }
+        assert(a.countIntersection(b) == numCommon);
+        assert(a.intersects(b) == (numCommon > 0));
+        assert(a.isSubsetOf(b) == subset);
+
+        // copyFrom into a bitset of equal or larger size
+        x = toBitset(randomReference(rng, std::max(sizeA, sizeB)));
+        x.copyFrom(a);
+        Reference rCopy(std::max(sizeA, sizeB), false);
+        for (size_t i = 0; i < sizeA; i++) rCopy[i] = ra[i];
+        assert(equals(x, rCopy));
+    }
+
+    Log::i("All bitset tests passed\n");
+}
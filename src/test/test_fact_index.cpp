@@ -0,0 +1,129 @@
+
+#include <random>
+#include <algorithm>
+#include <assert.h>
+
+#include "util/timer.h"
+#include "util/log.h"
+#include "util/params.h"
+
+#include "data/htn_instance.h"
+#include "data/fact_index.h"
+#include "algo/arg_iterator.h"
+
+// Usage: test_fact_index <domain.hddl> <problem.hddl>
+int main(int argc, char** argv) {
+
+    Timer::init();
+
+    Parameters params;
+    params.init(argc, argv);
+
+    int verbosity = params.getIntParam("v");
+    Log::init(verbosity, /*coloredOutput=*/params.isNonzero("co"));
+
+    HtnInstance htn(params);
+    FactIndex index(htn);
+
+    // Full ground domain of each predicate occurring in the initial state
+    USigSet init = htn.getInitState();
+    FlatHashMap<int, std::vector<std::vector<int>>> domains;
+    for (const auto& fact : init) {
+        if (domains.count(fact._name_id)) continue;
+        auto& domain = domains[fact._name_id];
+        for (int sort : htn.getSorts(fact._name_id)) {
+            domain.emplace_back();
+            for (int c : htn.getConstantsOfSort(sort)) if (!htn.isQConstant(c)) domain.back().push_back(c);
+        }
+    }
+    assert(!domains.empty());
+
+    // IDs are unique and within bounds; getDecodingIds enumerates them in ArgIterator order
+    FlatHashSet<long> ids;
+    bool indexable;
+    USigSet allFacts;
+    std::vector<size_t> decodingIds;
+    for (const auto& [predId, domain] : domains) {
+        indexable = index.getDecodingIds(predId, domain, decodingIds);
+        assert(indexable);
+        size_t i = 0;
+        for (const auto& fact : ArgIterator(predId, std::vector<std::vector<int>>(domain))) {
+            long id = index.getId(fact);
+            assert(id >= 0 && (size_t)id < index.size());
+            bool unique = ids.insert(id).second;
+            assert(unique || Log::e("Duplicate ID %li for %s\n", id, TOSTR(fact)));
+            assert(i < decodingIds.size() && decodingIds[i] == (size_t)id);
+            allFacts.insert(fact);
+            i++;
+        }
+        assert(i == decodingIds.size());
+    }
+    for (const auto& fact : init) assert(index.getId(fact) >= 0);
+
+    // Facts with an argument outside of the predicate's sorts are not indexed
+    int qconst = -1;
+    for (const auto& [predId, domain] : domains) {
+        if (domain.empty()) continue;
+        USignature fact(predId, std::vector<int>(domain.size()));
+        for (size_t a = 0; a < domain.size(); a++) fact._args[a] = domain[a].front();
+        fact._args[0] = qconst;
+        assert(index.getId(fact) < 0);
+        std::vector<std::vector<int>> eligible(domain);
+        eligible[0].push_back(qconst);
+        indexable = index.getDecodingIds(predId, eligible, decodingIds);
+        assert(!indexable);
+        break;
+    }
+
+    // DenseFactSet behaves like a set of facts, including non-indexed fallback facts
+    std::vector<USignature> universe(allFacts.begin(), allFacts.end());
+    for (const auto& [predId, domain] : domains) {
+        if (domain.empty()) continue;
+        for (int k = 0; k < 3; k++) universe.emplace_back(predId, std::vector<int>(domain.size(), qconst-k));
+    }
+    std::mt19937 rng(1);
+    DenseFactSet set(index);
+    USigSet reference;
+    for (int op = 0; op < 20000; op++) {
+        const auto& fact = universe[rng() % universe.size()];
+        bool changed, changedReference;
+        if (rng() % 2) {
+            changed = set.insert(fact);
+            changedReference = reference.insert(fact).second;
+        } else {
+            changed = set.erase(fact);
+            changedReference = reference.erase(fact) > 0;
+        }
+        assert(changed == changedReference);
+        assert(set.size() == reference.size());
+    }
+    for (const auto& fact : universe) assert(set.contains(fact) == (reference.count(fact) > 0));
+
+    // The fingerprint only depends on the contents, not on the order of insertion
+    DenseFactSet shuffled(index);
+    std::vector<USignature> contents(reference.begin(), reference.end());
+    std::shuffle(contents.begin(), contents.end(), rng);
+    for (const auto& fact : contents) shuffled.insert(fact);
+    assert(shuffled.getFingerprint() == set.getFingerprint());
+    if (!contents.empty()) {
+        shuffled.erase(contents.front());
+        assert(shuffled.getFingerprint() != set.getFingerprint());
+        shuffled.insert(contents.front());
+        assert(shuffled.getFingerprint() == set.getFingerprint());
+    }
+
+    // assign() overwrites the previous contents
+    DenseFactSet copy(index);
+    copy.insert(universe.back());
+    copy.insert(universe.front());
+    copy.assign(set);
+    assert(copy.size() == set.size());
+    assert(copy.getFingerprint() == set.getFingerprint());
+    for (const auto& fact : universe) assert(copy.contains(fact) == set.contains(fact));
+
+    copy.clear();
+    assert(copy.size() == 0 && copy.getFingerprint() == 0);
+    for (const auto& fact : universe) assert(!copy.contains(fact));
+
+    Log::i("All fact index tests passed\n");
+}
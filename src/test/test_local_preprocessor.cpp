@@ -0,0 +1,196 @@
+
+#include <random>
+#include <cstdlib>
+#include <algorithm>
+#include <assert.h>
+
+#include "util/timer.h"
+#include "util/log.h"
+#include "util/params.h"
+
+#include "sat/local_preprocessor.h"
+
+typedef std::vector<std::vector<int>> Cnf;
+
+bool satisfies(const Cnf& cnf, const std::vector<bool>& assignment) {
+    for (const auto& cls : cnf) {
+        bool sat = false;
+        for (int lit : cls) if (assignment[std::abs(lit)] == (lit > 0)) {
+            sat = true;
+            break;
+        }
+        if (!sat) return false;
+    }
+    return true;
+}
+
+// Is there an assignment to the local variables (vars [numGlobal+1, numVars])
+// which satisfies the formula together with the given global assignment?
+bool hasLocalExtension(const Cnf& cnf, std::vector<bool>& assignment, int numGlobal, int numVars) {
+    for (long bits = 0; bits < (1l << (numVars-numGlobal)); bits++) {
+        for (int v = numGlobal+1; v <= numVars; v++) assignment[v] = (bits >> (v-numGlobal-1)) & 1;
+        if (satisfies(cnf, assignment)) return true;
+    }
+    return false;
+}
+
+Cnf process(const Cnf& cnf, const std::vector<int>& localVars, LocalPreprocessor& pp) {
+    for (const auto& cls : cnf) pp.add(cls);
+    pp.process(localVars);
+    Cnf result;
+    pp.forEachClause([&](const std::vector<int>& cls) {result.push_back(cls);});
+    return result;
+}
+
+// Checks that the processed formula has exactly the same models as the original one
+// when projected onto the global (non-local) variables
+void checkProjectionPreserved(const Cnf& original, const Cnf& processed, int numGlobal, int numVars) {
+    std::vector<bool> assignment(numVars+1);
+    for (long bits = 0; bits < (1l << numGlobal); bits++) {
+        for (int v = 1; v <= numGlobal; v++) assignment[v] = (bits >> (v-1)) & 1;
+        bool before = hasLocalExtension(original, assignment, numGlobal, numVars);
+        bool after = hasLocalExtension(processed, assignment, numGlobal, numVars);
+        assert(before == after || Log::e("Projection changed by preprocessing!\n"));
+    }
+}
+
+size_t numOccurringVars(const Cnf& cnf, const std::vector<int>& vars) {
+    size_t num = 0;
+    for (int var : vars) {
+        bool occurs = false;
+        for (const auto& cls : cnf) for (int lit : cls) if (std::abs(lit) == var) occurs = true;
+        if (occurs) num++;
+    }
+    return num;
+}
+
+int main(int argc, char** argv) {
+
+    Timer::init();
+
+    Parameters params;
+    params.init(argc, argv);
+
+    int verbosity = params.getIntParam("v");
+    Log::init(verbosity, /*coloredOutput=*/params.isNonzero("co"));
+
+    // Random small formulas: projection onto the global variables is preserved
+    std::mt19937 rng(1);
+    size_t totalEliminated = 0;
+    for (int round = 0; round < 2000; round++) {
+        int numGlobal = 1 + rng() % 5;
+        int numLocal = 1 + rng() % 5;
+        int numVars = numGlobal + numLocal;
+        Cnf cnf;
+        int numClauses = 1 + rng() % 12;
+        for (int c = 0; c < numClauses; c++) {
+            std::vector<int> cls;
+            int len = 1 + rng() % 4;
+            // (may contain duplicate literals and tautologies)
+            for (int i = 0; i < len; i++) cls.push_back((1 + rng() % numVars) * (rng() % 2 ? 1 : -1));
+            cnf.push_back(cls);
+        }
+        // Duplicate clauses
+        if (round % 3 == 0) cnf.push_back(cnf[rng() % cnf.size()]);
+
+        std::vector<int> localVars;
+        for (int v = numGlobal+1; v <= numVars; v++) localVars.push_back(v);
+
+        LocalPreprocessor pp;
+        Cnf processed = process(cnf, localVars, pp);
+        checkProjectionPreserved(cnf, processed, numGlobal, numVars);
+        totalEliminated += pp.getNumEliminatedVars();
+    }
+    assert(totalEliminated > 0);
+
+    // Tautologies are dropped, duplicate literals are merged
+    {
+        LocalPreprocessor pp;
+        Cnf processed = process({{1, -1, 2}, {3, 3, -4}}, {}, pp);
+        assert(processed.size() == 1);
+        assert((processed[0] == std::vector<int>{-4, 3}));
+    }
+
+    // A pure local variable is eliminated together with all of its clauses
+    {
+        LocalPreprocessor pp;
+        Cnf processed = process({{1, 2, 3}, {-1, 3}}, {3}, pp);
+        assert(pp.getNumEliminatedVars() == 1);
+        assert(processed.empty());
+    }
+
+    // Of two duplicate clauses, exactly one is kept
+    {
+        LocalPreprocessor pp;
+        // 3 is kept: its 6 resolvents would outnumber its 5 clauses
+        Cnf processed = process({{1, 2, 3}, {3, 2, 1}, {-3, 4}, {-3, 5}, {-3, 6}}, {3}, pp);
+        assert(pp.getNumEliminatedVars() == 0);
+        assert(pp.getNumSubsumedClauses() == 1);
+        assert(processed.size() == 4);
+        size_t numWith3 = 0;
+        for (const auto& cls : processed) if (std::find(cls.begin(), cls.end(), 3) != cls.end()) numWith3++;
+        assert(numWith3 == 1);
+    }
+
+    // Subsumption: clauses with a remaining local variable subsumed by another clause are removed
+    {
+        LocalPreprocessor pp;
+        // 5 occurs too often to be eliminated, and {1, 5} subsumes {1, 2, 5}
+        Cnf cnf = {{1, 5}, {1, 2, 5}};
+        for (int i = 0; i < 40; i++) {
+            cnf.push_back({5, 10+i});
+            cnf.push_back({-5, 100+i});
+        }
+        Cnf processed = process(cnf, {5}, pp);
+        assert(pp.getNumEliminatedVars() == 0);
+        assert(pp.getNumSubsumedClauses() == 1);
+        assert(processed.size() == cnf.size()-1);
+    }
+
+    // Occurrence cap: a variable whose #pos * #neg exceeds the cap is kept
+    {
+        size_t n = 1;
+        while (n*n <= LocalPreprocessor::MAX_OCCURRENCE_PRODUCT) n++;
+        Cnf cnf;
+        for (size_t i = 0; i < n; i++) {
+            // All resolvents are tautologies, so elimination would otherwise succeed
+            cnf.push_back({1, 1000, 2000+(int)i});
+            cnf.push_back({-1, -1000, 3000+(int)i});
+        }
+        LocalPreprocessor pp;
+        Cnf processed = process(cnf, {1}, pp);
+        assert(pp.getNumEliminatedVars() == 0);
+        assert(numOccurringVars(processed, {1}) == 1);
+
+        // Just below the cap, the same variable is eliminated
+        cnf.resize(2*(n-1));
+        LocalPreprocessor pp2;
+        processed = process(cnf, {1}, pp2);
+        assert(pp2.getNumEliminatedVars() == 1);
+        assert(numOccurringVars(processed, {1}) == 0);
+    }
+
+    // Resolvent length cap: a variable with an overlong resolvent is kept
+    {
+        std::vector<int> pos{1}, neg{-1};
+        for (size_t i = 0; i < LocalPreprocessor::MAX_RESOLVENT_LENGTH; i++) {
+            pos.push_back(100+i);
+            neg.push_back(200+i);
+        }
+        LocalPreprocessor pp;
+        Cnf processed = process({pos, neg}, {1}, pp);
+        assert(pp.getNumEliminatedVars() == 0);
+        assert(processed.size() == 2);
+    }
+
+    // Elimination which would increase the number of clauses is not performed
+    {
+        Cnf cnf = {{1, 2}, {1, 3}, {1, 4}, {-1, 5}, {-1, 6}, {-1, 7}};
+        LocalPreprocessor pp;
+        Cnf processed = process(cnf, {1}, pp);
+        assert(pp.getNumEliminatedVars() == 0);
+        assert(processed.size() == cnf.size());
+    }
+
+    Log::i("All local preprocessor tests passed\n");
+}
@@ -0,0 +1,218 @@
+
+#include <unistd.h>
+
+#include "util/timer.h"
+#include "util/log.h"
+#include "util/params.h"
+#include "util/spill_file.h"
+#include "util/names.h"
+
+#include "data/position.h"
+
+struct Snapshot {
+    USigSet actions;
+    USigSet reductions;
+    NodeHashMap<USignature, USigSet, USignatureHasher> expansions;
+    NodeHashMap<USignature, USigSet, USignatureHasher> predecessors;
+    NodeHashMap<USignature, int, USignatureHasher> opVars;
+
+    // Takes a snapshot of the mutable form of the position (thawing it if necessary)
+    Snapshot(Position& p) : actions(p.getActions()), reductions(p.getReductions()),
+            expansions(p.getExpansions()), predecessors(p.getPredecessors()) {
+        p.forEachOpVariable([&](const USignature& sig, int var) {opVars[sig] = var;});
+    }
+
+    bool operator==(const Snapshot& other) const {
+        return actions == other.actions && reductions == other.reductions
+            && expansions == other.expansions && predecessors == other.predecessors
+            && opVars == other.opVars;
+    }
+};
+
+// Checks the read-only queries of a (possibly frozen or spilled) position against a snapshot
+void checkQueries(const Position& p, const Snapshot& s) {
+    for (const auto& a : s.actions) assert(p.hasAction(a));
+    for (const auto& r : s.reductions) assert(p.hasReduction(r));
+    assert(!p.hasAction(USignature(999, {1})));
+    assert(!p.hasReduction(USignature(999, {1})));
+    size_t numOpVars = 0;
+    p.forEachOpVariable([&](const USignature& sig, int var) {
+        assert(s.opVars.count(sig) && s.opVars.at(sig) == var);
+        numOpVars++;
+    });
+    assert(numOpVars == s.opVars.size());
+    for (const auto& [sig, var] : s.opVars) {
+        assert(p.hasVariable(VarType::OP, sig));
+        assert(p.getVariableOrZero(VarType::OP, sig) == var);
+    }
+    assert(p.getVariableOrZero(VarType::OP, USignature(999, {1})) == 0);
+    for (const auto& [parent, children] : s.expansions) {
+        USigSet found;
+        p.forEachExpansion(parent, [&](const USignature& child) {found.insert(child);});
+        assert(found == children);
+        assert(p.getNumExpansions(parent) == children.size());
+        for (const auto& child : children) assert(p.hasExpansion(parent, child));
+        assert(!p.hasExpansion(parent, USignature(999, {1})));
+    }
+    for (const auto& [child, parents] : s.predecessors) {
+        USigSet found;
+        p.forEachPredecessor(child, [&](const USignature& parent) {found.insert(parent);});
+        assert(found == parents);
+        assert(p.hasPredecessors(child));
+        assert(p.getNumPredecessors(child) == parents.size());
+    }
+    assert(p.getNumExpansions(USignature(999, {1})) == 0);
+    assert(!p.hasPredecessors(USignature(999, {1})));
+    assert(p.getNumPredecessors(USignature(999, {1})) == 0);
+}
+
+void fill(Position& p, int seed) {
+    int var = 1;
+    for (int i = 0; i < 20; i++) {
+        USignature action(10 + i % 3, {seed, i, i*i});
+        p.addAction(action);
+        p.setVariable(VarType::OP, action, var++);
+    }
+    for (int i = 0; i < 10; i++) {
+        USignature red(20 + i % 2, {seed, i});
+        p.addReduction(red);
+        p.setVariable(VarType::OP, red, var++);
+        // Parents at the layer above
+        for (int j = 0; j <= i % 3; j++) p.addExpansion(USignature(30, {j}), red);
+    }
+    // Ops with empty argument lists
+    p.addAction(USignature(40, {}));
+    p.setVariable(VarType::OP, USignature(40, {}), var++);
+    p.addExpansion(USignature(30, {}), USignature(40, {}));
+}
+
+int main(int argc, char** argv) {
+
+    Timer::init();
+
+    Parameters params;
+    params.init(argc, argv);
+
+    int verbosity = params.getIntParam("v");
+    Log::init(verbosity, /*coloredOutput=*/params.isNonzero("co"));
+
+    NodeHashMap<int, std::string> names;
+    for (int id : {10, 11, 12, 20, 21, 30, 40, 50, 999}) names[id] = "op" + std::to_string(id);
+    for (int c = 0; c < 400; c++) names[c] = "c" + std::to_string(c);
+    Names::init(names);
+
+    // Empty position
+    {
+        Position p;
+        p.setPos(0, 0);
+        Snapshot before(p);
+        p.freeze();
+        assert(p.isFrozen());
+        checkQueries(p, before);
+        p.thaw();
+        assert(!p.isFrozen());
+        assert(Snapshot(p) == before);
+    }
+
+    // freeze() and thaw()
+    {
+        Position p;
+        p.setPos(1, 2);
+        fill(p, 1);
+        Snapshot before(p);
+        p.freeze();
+        p.freeze(); // no-op
+        assert(p.isFrozen() && !p.isSpilled());
+        checkQueries(p, before);
+        p.thaw();
+        assert(!p.isFrozen());
+        assert(Snapshot(p) == before);
+
+        // Modification of a frozen position thaws it
+        p.freeze();
+        p.addAction(USignature(50, {7}));
+        assert(!p.isFrozen());
+        assert(p.hasAction(USignature(50, {7})));
+        p.removeActionOccurrence(USignature(50, {7}));
+        assert(Snapshot(p) == before);
+    }
+
+    // serialize() and deserialize() of the frozen form
+    {
+        FrozenPosition f;
+        f.actions.add(USignature(1, {2, 3}));
+        f.actions.add(USignature(4, {}));
+        f.opSigs.add(USignature(1, {2, 3}));
+        f.opVars.push_back(17);
+        f.expansionParents.add(USignature(5, {6}));
+        f.expansionOffsets = {0, 1};
+        f.expansionChildren.add(USignature(1, {2, 3}));
+        std::vector<uint8_t> buf;
+        f.serialize(buf);
+        FrozenPosition g;
+        g.deserialize(buf.data());
+        assert(g.actions.size() == 2 && g.actions.get(0) == USignature(1, {2, 3}) && g.actions.get(1) == USignature(4, {}));
+        assert(g.reductions.size() == 0);
+        assert(g.getOpVariableOrZero(USignature(1, {2, 3})) == 17);
+        assert(g.expansionOffsets == f.expansionOffsets);
+        assert(g.expansionParents.get(0) == USignature(5, {6}));
+        assert(g.expansionChildren.get(0) == USignature(1, {2, 3}));
+        assert(g.predecessorOffsets.empty());
+    }
+
+    // spill() and page-in through a spill file
+    {
+        char dir[] = "/tmp/lilotane_test_XXXXXX";
+        bool createdDir = mkdtemp(dir) != nullptr;
+        assert(createdDir);
+        SpillFile file(dir);
+
+        std::vector<Position> positions(3);
+        std::vector<Snapshot> snapshots;
+        for (size_t i = 0; i < positions.size(); i++) {
+            positions[i].setPos(2, i);
+            fill(positions[i], i);
+            snapshots.emplace_back(positions[i]);
+            positions[i].spill(file);
+            assert(positions[i].isSpilled() && positions[i].isFrozen());
+        }
+        size_t spilledSize = file.size();
+        assert(spilledSize > 0);
+
+        // Queries page the data back in without thawing
+        for (size_t i = 0; i < positions.size(); i++) {
+            checkQueries(positions[i], snapshots[i]);
+            assert(!positions[i].isSpilled() && positions[i].isFrozen());
+        }
+
+        // Spilling unmodified data again does not write it twice
+        for (auto& p : positions) p.spill(file);
+        assert(file.size() == spilledSize);
+
+        // Thawing a spilled position restores its mutable form
+        for (size_t i = 0; i < positions.size(); i++) {
+            positions[i].thaw();
+            assert(!positions[i].isFrozen());
+            assert(Snapshot(positions[i]) == snapshots[i]);
+        }
+
+        // Spilling thawed but unmodified positions does not write them again
+        for (auto& p : positions) p.spill(file);
+        assert(file.size() == spilledSize);
+        for (size_t i = 0; i < positions.size(); i++) {
+            assert(positions[i].isSpilled());
+            checkQueries(positions[i], snapshots[i]);
+        }
+
+        // A modified position is written again, with its new contents
+        positions[0].addAction(USignature(50, {7}));
+        positions[0].spill(file);
+        assert(file.size() > spilledSize);
+        assert(positions[0].hasAction(USignature(50, {7})));
+        positions[0].removeActionOccurrence(USignature(50, {7}));
+        assert(Snapshot(positions[0]) == snapshots[0]);
+        rmdir(dir);
+    }
+
+    Log::i("All position freeze/spill tests passed\n");
+}
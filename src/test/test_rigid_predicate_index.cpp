@@ -0,0 +1,107 @@
+
+#include <random>
+#include <algorithm>
+#include <assert.h>
+
+#include "util/timer.h"
+#include "util/log.h"
+#include "util/params.h"
+
+#include "algo/rigid_predicate_index.h"
+
+// Brute force version of RigidPredicateIndex::getPossibleConstants
+FlatHashSet<int> getPossibleConstants(const USigSet& facts, int predId, size_t queriedPos,
+        const std::vector<std::vector<int>>& eligibleArgs) {
+    FlatHashSet<int> result;
+    for (const auto& fact : facts) {
+        if (fact._name_id != predId) continue;
+        bool matches = true;
+        for (size_t pos = 0; pos < fact._args.size(); pos++) {
+            if (pos == queriedPos) continue;
+            const auto& eligible = eligibleArgs[pos];
+            if (std::find(eligible.begin(), eligible.end(), fact._args[pos]) == eligible.end()) matches = false;
+        }
+        if (matches) result.insert(fact._args[queriedPos]);
+    }
+    return result;
+}
+
+int main(int argc, char** argv) {
+
+    Timer::init();
+
+    Parameters params;
+    params.init(argc, argv);
+
+    int verbosity = params.getIntParam("v");
+    Log::init(verbosity, /*coloredOutput=*/params.isNonzero("co"));
+
+    std::mt19937 rng(1);
+    int numConstants = 8;
+
+    // Random facts and queries are answered like by brute force
+    for (int round = 0; round < 300; round++) {
+        USigSet facts;
+        std::vector<size_t> arities{1, 2, 3};
+        for (size_t p = 0; p < arities.size(); p++) {
+            int numFacts = rng() % 40;
+            for (int f = 0; f < numFacts; f++) {
+                USignature fact(p, std::vector<int>(arities[p]));
+                for (int& arg : fact._args) arg = 1 + rng() % numConstants;
+                facts.insert(fact);
+            }
+        }
+        RigidPredicateIndex index;
+        index.build(facts, FlatHashSet<int>());
+
+        for (int query = 0; query < 30; query++) {
+            int predId = rng() % arities.size();
+            if (!index.hasPredicate(predId)) continue;
+            size_t queriedPos = rng() % arities[predId];
+            std::vector<std::vector<int>> eligibleArgs(arities[predId]);
+            for (auto& eligible : eligibleArgs) {
+                // May contain duplicates and constants without any fact
+                int numEligible = rng() % 6;
+                for (int i = 0; i < numEligible; i++) eligible.push_back(1 + rng() % (numConstants+2));
+            }
+            FlatHashSet<int> expected = getPossibleConstants(facts, predId, queriedPos, eligibleArgs);
+
+            FlatHashSet<int> result;
+            bool withinLimit = index.getPossibleConstants(predId, queriedPos, eligibleArgs, SIZE_MAX, result);
+            assert(withinLimit);
+            assert(result == expected);
+
+            // Exceeding the limit is reported
+            if (!expected.empty()) {
+                result.clear();
+                withinLimit = index.getPossibleConstants(predId, queriedPos, eligibleArgs, expected.size()-1, result);
+                assert(!withinLimit);
+                result.clear();
+                withinLimit = index.getPossibleConstants(predId, queriedPos, eligibleArgs, expected.size(), result);
+                assert(withinLimit && result == expected);
+            }
+        }
+    }
+
+    // Excluded and unknown predicates are not indexed and yield no constants
+    {
+        USigSet facts{USignature(1, {2, 3}), USignature(4, {5})};
+        RigidPredicateIndex index;
+        index.build(facts, FlatHashSet<int>{4});
+        assert(index.hasPredicate(1));
+        assert(!index.hasPredicate(4));
+        assert(!index.hasPredicate(6));
+        FlatHashSet<int> result;
+        bool withinLimit = index.getPossibleConstants(4, 0, {{}}, 0, result);
+        assert(withinLimit && result.empty());
+
+        // Rebuilding replaces the previous contents
+        index.build(USigSet{USignature(4, {5})}, FlatHashSet<int>());
+        assert(!index.hasPredicate(1));
+        assert(index.hasPredicate(4));
+        withinLimit = index.getPossibleConstants(4, 0, {{}}, 1, result);
+        assert(withinLimit && result == FlatHashSet<int>{5});
+    }
+
+    Log::i("All rigid predicate index tests passed\n");
+}
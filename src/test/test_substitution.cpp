@@ -0,0 +1,162 @@
+
+#include <map>
+#include <random>
+#include <assert.h>
+
+#include "util/timer.h"
+#include "util/log.h"
+#include "util/params.h"
+
+#include "data/substitution.h"
+
+typedef std::map<int, int> Reference;
+
+bool equals(const Substitution& s, const Reference& r) {
+    if (s.size() != r.size() || s.empty() != r.empty()) return false;
+    // Iteration is in ascending order of keys
+    auto it = r.begin();
+    for (const auto& [key, val] : s) {
+        if (key != it->first || val != it->second) return false;
+        ++it;
+    }
+    for (const auto& [key, val] : r) {
+        if (!s.count(key) || s.at(key) != val || s.find(key)->second != val) return false;
+    }
+    return true;
+}
+
+Reference randomReference(std::mt19937& rng, size_t size) {
+    Reference r;
+    while (r.size() < size) r[1 + rng() % 50] = 1 + rng() % 50;
+    return r;
+}
+
+Substitution toSubstitution(const Reference& r) {
+    Substitution s;
+    for (const auto& [key, val] : r) s[key] = val;
+    return s;
+}
+
+int main(int argc, char** argv) {
+
+    Timer::init();
+
+    Parameters params;
+    params.init(argc, argv);
+
+    int verbosity = params.getIntParam("v");
+    Log::init(verbosity, /*coloredOutput=*/params.isNonzero("co"));
+
+    std::mt19937 rng(1);
+    // Sizes around the inline capacity and the linear search limit
+    std::vector<size_t> sizes{0, 1, Substitution::INLINE_CAPACITY-1, Substitution::INLINE_CAPACITY,
+        Substitution::INLINE_CAPACITY+1, Substitution::LINEAR_SEARCH_LIMIT, Substitution::LINEAR_SEARCH_LIMIT+1, 30};
+
+    // Insertion and lookup in random order
+    for (int round = 0; round < 1000; round++) {
+        Substitution s;
+        Reference r;
+        int numOps = rng() % 40;
+        for (int op = 0; op < numOps; op++) {
+            int key = 1 + rng() % 50;
+            int val = 1 + rng() % 50;
+            s[key] = val;
+            r[key] = val;
+            assert(equals(s, r));
+        }
+        for (int key = 0; key <= 51; key++) {
+            if (r.count(key)) continue;
+            assert(!s.count(key));
+            assert(s.find(key) == s.end());
+        }
+        s.clear();
+        assert(equals(s, Reference()));
+        // Reusable after clearing
+        s[7] = 8;
+        assert(equals(s, Reference{{7, 8}}));
+    }
+
+    // Copy and move between inline and heap storage
+    for (size_t sizeA : sizes) for (size_t sizeB : sizes) {
+        Reference ra = randomReference(rng, sizeA);
+        Reference rb = randomReference(rng, sizeB);
+        Substitution a = toSubstitution(ra);
+
+        Substitution copy(a);
+        assert(equals(copy, ra) && copy == a);
+        copy = toSubstitution(rb);
+        assert(equals(copy, rb) && equals(a, ra));
+        copy = a;
+        assert(equals(copy, ra));
+        // The copy is independent of the original
+        copy[100] = 1;
+        assert(equals(a, ra) && copy != a);
+
+        Substitution moved(std::move(copy));
+        assert(moved.size() == ra.size()+1);
+        moved = toSubstitution(rb);
+        assert(equals(moved, rb));
+        Substitution source(a);
+        moved = std::move(source);
+        assert(equals(moved, ra));
+        // Growing after a move keeps the entries sorted
+        moved[0] = 5;
+        Reference rm(ra);
+        rm[0] = 5;
+        assert(equals(moved, rm));
+    }
+
+    // Construction from source and destination arguments
+    {
+        Substitution s({1, 2, 3, 2}, {4, 2, 5, 2});
+        assert(equals(s, Reference{{1, 4}, {3, 5}}));
+    }
+
+    // apply()
+    for (size_t size : sizes) {
+        Reference r = randomReference(rng, size);
+        Substitution s = toSubstitution(r);
+        std::vector<int> args, expected;
+        for (int i = 0; i < 20; i++) {
+            args.push_back(1 + rng() % 60);
+            expected.push_back(r.count(args.back()) ? r[args.back()] : args.back());
+        }
+        s.apply(args);
+        assert(args == expected);
+    }
+
+    // Both versions of concatenate() are equivalent to composing the mappings
+    for (size_t sizeA : sizes) for (size_t sizeB : sizes) {
+        Reference ra = randomReference(rng, sizeA);
+        Reference rb = randomReference(rng, sizeB);
+        Reference expected;
+        for (const auto& [key, val] : ra) expected[key] = rb.count(val) ? rb[val] : val;
+        for (const auto& [key, val] : rb) if (!expected.count(key)) expected[key] = val;
+
+        Substitution a = toSubstitution(ra);
+        Substitution b = toSubstitution(rb);
+        assert(equals(a.concatenate(b), expected));
+        assert(equals(a, ra));
+        assert(equals(std::move(a).concatenate(b), expected));
+    }
+
+    // Equal substitutions have equal hashes, regardless of how they were built
+    for (size_t size : sizes) {
+        Reference r = randomReference(rng, size);
+        Substitution a = toSubstitution(r);
+        Substitution b;
+        for (auto it = r.rbegin(); it != r.rend(); ++it) b[it->first] = it->second;
+        assert(a == b);
+        assert(Substitution::Hasher()(a) == Substitution::Hasher()(b));
+    }
+
+    // getAll() branches on conflicting assignments
+    {
+        auto all = Substitution::getAll({1, 2, 1}, {3, 4, 5});
+        assert(all.size() == 2);
+        assert(equals(all[0], Reference{{1, 3}, {2, 4}}));
+        assert(equals(all[1], Reference{{1, 5}, {2, 4}}));
+    }
+
+    Log::i("All substitution tests passed\n");
+}
@@ -0,0 +1,130 @@
+
+#ifndef DOMPASCH_LILOTANE_BITSET_H
+#define DOMPASCH_LILOTANE_BITSET_H
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stddef.h>
+
+class Bitset {
+
+private:
+    std::vector<uint64_t> _words;
+    size_t _size = 0;
+
+public:
+    Bitset() = default;
+    Bitset(size_t size) {resize(size);}
+
+    inline void resize(size_t size) {
+        _size = size;
+        _words.resize((size + 63) / 64, 0);
+        // Clear the unused bits of the last word
+        if (_size % 64 != 0) _words.back() &= (uint64_t(1) << (_size % 64)) - 1;
+    }
+    inline void grow(size_t size) {
+        if (size > _size) resize(size);
+    }
+
+    inline size_t size() const {return _size;}
+
+    inline bool test(size_t i) const {
+        return i < _size && (_words[i >> 6] >> (i & 63)) & 1;
+    }
+    inline void set(size_t i) {
+        _words[i >> 6] |= uint64_t(1) << (i & 63);
+    }
+    inline void set(size_t i, bool value) {
+        if (value) set(i);
+        else reset(i);
+    }
+    inline void reset(size_t i) {
+        _words[i >> 6] &= ~(uint64_t(1) << (i & 63));
+    }
+
+    // Sets all bits to zero without releasing memory.
+    inline void clear() {
+        if (!_words.empty()) memset(_words.data(), 0, _words.size() * sizeof(uint64_t));
+    }
+    inline void fill() {
+        if (_words.empty()) return;
+        memset(_words.data(), 0xff, _words.size() * sizeof(uint64_t));
+        resize(_size);
+    }
+
+    // Copies the bits of the other bitset into this bitset (of equal or smaller size).
+    inline void copyFrom(const Bitset& other) {
+        grow(other._size);
+        if (!other._words.empty()) memcpy(_words.data(), other._words.data(), other._words.size() * sizeof(uint64_t));
+        for (size_t w = other._words.size(); w < _words.size(); w++) _words[w] = 0;
+    }
+
+    inline size_t count() const {
+        size_t c = 0;
+        for (uint64_t w : _words) c += __builtin_popcountll(w);
+        return c;
+    }
+    inline bool any() const {
+        for (uint64_t w : _words) if (w != 0) return true;
+        return false;
+    }
+
+    inline Bitset& operator&=(const Bitset& other) {
+        size_t n = std::min(_words.size(), other._words.size());
+        for (size_t w = 0; w < n; w++) _words[w] &= other._words[w];
+        for (size_t w = n; w < _words.size(); w++) _words[w] = 0;
+        return *this;
+    }
+    inline Bitset& operator|=(const Bitset& other) {
+        grow(other._size);
+        for (size_t w = 0; w < other._words.size(); w++) _words[w] |= other._words[w];
+        return *this;
+    }
+    // Removes all bits which are set in the other bitset.
+    inline Bitset& subtract(const Bitset& other) {
+        size_t n = std::min(_words.size(), other._words.size());
+        for (size_t w = 0; w < n; w++) _words[w] &= ~other._words[w];
+        return *this;
+    }
+
+    inline bool intersects(const Bitset& other) const {
+        size_t n = std::min(_words.size(), other._words.size());
+        for (size_t w = 0; w < n; w++) if (_words[w] & other._words[w]) return true;
+        return false;
+    }
+    inline size_t countIntersection(const Bitset& other) const {
+        size_t n = std::min(_words.size(), other._words.size());
+        size_t c = 0;
+        for (size_t w = 0; w < n; w++) c += __builtin_popcountll(_words[w] & other._words[w]);
+        return c;
+    }
+    // True iff all bits set in this bitset are also set in the other bitset.
+    inline bool isSubsetOf(const Bitset& other) const {
+        for (size_t w = 0; w < _words.size(); w++) {
+            uint64_t o = w < other._words.size() ? other._words[w] : 0;
+            if (_words[w] & ~o) return false;
+        }
+        return true;
+    }
+
+    // Calls f(i) for each set bit i in ascending order.
+    template <typename F>
+    inline void forEach(F f) const {
+        for (size_t w = 0; w < _words.size(); w++) {
+            uint64_t word = _words[w];
+            while (word != 0) {
+                size_t i = (w << 6) + __builtin_ctzll(word);
+                f(i);
+                word &= word - 1;
+            }
+        }
+    }
+
+    inline size_t getMemoryUsage() const {
+        return _words.capacity() * sizeof(uint64_t);
+    }
+};
+
+#endif
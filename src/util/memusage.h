@@ -15,7 +15,7 @@
 //
 // On failure, returns 0.0, 0.0
 
-void process_mem_usage(double& vm_usage, double& resident_set)
+inline void process_mem_usage(double& vm_usage, double& resident_set)
 {
    using std::ios_base;
    using std::ifstream;
@@ -39,6 +39,8 @@ void Parameters::init(int argc, char** argv) {
 void Parameters::setDefaults() {
     setParam("alo", "0"); // explicitly encode "at-least-one" over elements at each position
     setParam("bamot", "50"); // Binary at-most-one threshold
+    setParam("catt", "0"); // clause attribution: report the top-k contributing ops and predicates per layer (0: off)
+    setParam("cge", "0"); // core-guided expansion: only expand positions in the failed assumption core
     setParam("cleanup", "0"); // clean up before exit?
     setParam("co", "1"); // colored output
     setParam("cs", "0"); // check solvability (without assumptions)
@@ -46,8 +48,14 @@ void Parameters::setDefaults() {
     setParam("D", "0"); // max depth (= num iterations)
     setParam("edo", "1"); // eliminate dominated operations
     setParam("el", "0"); // extra layers after initial solution (-1: expand indefinitely)
+    setParam("eup", "1"); // encoder-side unit propagation: drop satisfied clauses and strip false literals
+    setParam("fpl", "0"); // freeze positions of past layers into a compact representation
     setParam("ip", "0"); // implicit primitiveness
+    setParam("lpp", "0"); // local preprocessing: eliminate auxiliary variables local to a position before passing its clauses to the solver
+    setParam("luf", "1"); // learnt unit feedback: prune ops which the solver learnt to be impossible
+    setParam("mem", "0"); // memory budget in MB (0: none)
     setParam("mp", "2"); // mine preconditions
+    setParam("ndv", "1"); // declare auxiliary variables as non-decision variables (and freeze assumed ones)
     setParam("nps", "0"); // non-primitive fact supports
     setParam("of", "0"); // optimization factor
     setParam("p", "1"); // encode predecessor operations
@@ -59,13 +67,17 @@ void Parameters::setDefaults() {
     setParam("q", "0"); // q-constants while always instantiating all preconditions
     setParam("qq", "1"); // q-constants without instantiation of preconditions
     setParam("s", "0"); // random seed
+    setParam("sic", "100000"); // subtask instantiation cache: max. number of entries
     setParam("sace", "0"); // split actions with (potentially) conflicting effects
+    setParam("spd", "/tmp"); // directory for spill file
+    setParam("spl", "0"); // spill positions of past layers to a memory-mapped scratch file
     setParam("sqq", "1"); // share q-constants
     setParam("srfa", "1"); // skip redundant frame axioms
     setParam("stats", "0"); // output domain statistics and exit
     setParam("stl", "0"); // SAT time limit
+    setParam("prof", "0"); // profile SAT calls: attribute learnt clauses and failed assumptions to ops, predicates and stages
     setParam("psr", "1"); // primitivize simple reductions
-    setParam("svp", "0"); // set variable phases
+    setParam("svp", "0"); // set variable phases of each new layer from the previous assignment
     setParam("T", "0"); // max. time (secs) for finding an initial plan
     setParam("tc", "1"); // tree conversion for DNF2CNF
     setParam("v", "2"); // verbosity
@@ -94,20 +106,37 @@ void Parameters::printUsage() {
     Log::i(" -aar=<0|1>          Acknowledge action repetitions and encode them in a reduced form\n");
     Log::i(" -alo=<0|1>          Explicitly encode at-least-one constraints over operations at each position\n");
     Log::i(" -bamot=<int>        Binary at-most-one threshold\n");
+    Log::i(" -catt=<k>           Clause attribution: report the k lifted ops and predicates contributing the most\n");
+    Log::i("                     clauses, literals and encoding time at each layer (0 : off)\n");
     Log::i(" -cleanup=<0|1>      0 to immediately exit through syscall after solution has been printed; 1 to exit normally\n");
     Log::i(" -co=<0|1>           Colored terminal output\n");
+    Log::i(" -cge=<0|1>          Core-guided expansion: if a layer is unsolvable, only expand positions whose primitiveness\n");
+    Log::i("                     assumption is in the failed core; repeat the reductions of all other positions\n");
     Log::i(" -cs=<0|1>           Check solvability: When some layer is UNSAT, re-run SAT solver without assumptions\n");
     Log::i("                     to see whether the formula has become generally unsatisfiable\n");
     Log::i(" -d=<depth>          Minimum depth to begin SAT solving at\n");
     Log::i(" -D=<depth>          Maximum depth to explore (0 : no limit)\n");
     Log::i(" -el=<int>           Number of extra layers to encode after an initial solution was found (use with -of=...)\n");
+    Log::i(" -eup=<0|1>          Encoder-side unit propagation: keep track of unit clauses, drop clauses satisfied by them\n");
+    Log::i("                     and strip literals falsified by them before clauses are passed to the solver\n");
+    Log::i(" -fpl=<0|1>          Freeze positions of past layers: store their operations in a compact read-only form\n");
     Log::i(" -ip=<0|1>           Implicit primitiveness instead of defining each op as primitive XOR nonprimitive\n");
+    Log::i(" -lpp=<0|1>          Local preprocessing: bounded variable elimination and subsumption over the clauses of each\n");
+    Log::i("                     position, restricted to auxiliary variables which occur at this position only\n");
+    Log::i(" -luf=<0|1>          Learnt unit feedback: before expanding an unsolvable layer, prune its operations\n");
+    Log::i("                     which the SAT solver learnt to be impossible\n");
+    Log::i(" -mem=<MB>           Memory budget: as the resident set size approaches <MB>, drop caches, lower limits,\n");
+    Log::i("                     spill past layers and finally stop expanding (0 : no budget)\n");
     Log::i(" -mp=<0|1|2>         Mine preconditions for reductions from their (recursive) subtasks:\n");
     Log::i("                     0=none, 1=use mined prec. for instantiation only, 2=use mined prec. everywhere\n");
+    Log::i(" -ndv=<0|1>          Declare auxiliary variables (e.g. binary AMO digits, plan length counters) as non-decision\n");
+    Log::i("                     variables and freeze auxiliary variables occurring in assumptions, if the solver supports it\n");
     Log::i(" -nps=<0|1>          Nonprimitive support: Enable encoding explicit fact supports for reductions\n");
     Log::i(" -of=<factor>        Plan length optimization factor: spend up to <factor> * <original solving time> for optimization\n");
     Log::i("                     (-1 for exhaustive optimization)\n");
     Log::i(" -p=<0|1>            Encode predecessor operations\n");
+    Log::i(" -prof=<0|1>         Profile SAT calls: attribute learnt clauses and failed assumptions to lifted operations,\n");
+    Log::i("                     predicates and encoding stages\n");
     Log::i(" -psr=<0|1>          Primitivize simple reductions\n");
     Log::i(" -pvn=<0|1>          Print variable names\n");
     Log::i(" -qcm=<limit>        Collect up to <limit> q-constant mutexes per tuple of q-constants\n");
@@ -117,10 +146,18 @@ void Parameters::printUsage() {
     Log::i("                     after fully instantiating all preconditions\n");
     Log::i(" -qq=<0|1>           For each action and reduction, introduces q-constants for ALL ambiguous free parameters (replaces -q)\n");
     Log::i(" -s=<int>            Random seed\n");
+    Log::i(" -sic=<limit>        Cache up to <limit> instantiations of subtasks under some set of reachable facts (0: no caching)\n");
+    Log::i(" -solver=<name|path> Load the SAT solver at runtime from libipasir<name>.so (searched in the library path\n");
+    Log::i("                     and in lib/<name>/) or from the given shared library instead of the linked solver\n");
+    Log::i(" -spd=<dir>          Directory in which the scratch file for -spl=1 is created\n");
+    Log::i(" -spl=<0|1>          Spill past layers: move operations and op variables of fully encoded layers\n");
+    Log::i("                     into a memory-mapped scratch file; they are paged back in on demand\n");
     Log::i(" -sqq=<0|1>          Share q-constants among operations of a position if they have the same effective domain\n");
     Log::i(" -srfa=<0|1>         Skip redundant frame axioms\n");
     Log::i(" -stats=<0|1>        Output domain statistics and exit\n");
     Log::i(" -stl=<limit>        SAT time limit: Set limit in seconds for a SAT solver call. Limit is discarded after first such interrupt.\n");
+    Log::i(" -svp=<0|1>          Set variable phases of each new layer from the last satisfying assignment via the\n");
+    Log::i("                     expansion structure (if the solver ignores phases: try seeded ops as assumptions first)\n");
     Log::i(" -T=<0|secs>         Try finding an initial plan for up to #secs (without optimization: total allowed runtime; 0: no limit)\n");
     Log::i(" -tc=<0|1>           Use tree conversion for DNF 2 CNF transformation instead of distributive law\n");
     Log::i(" -v=<verb>           Verbosity: 0=essential 1=warnings 2=information 3=verbose 4=debug\n");
@@ -0,0 +1,57 @@
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+
+#include "util/spill_file.h"
+#include "util/log.h"
+
+SpillFile::SpillFile(const std::string& directory) {
+    std::string pattern = directory + "/lilotane_spill_XXXXXX";
+    std::vector<char> path(pattern.begin(), pattern.end());
+    path.push_back('\0');
+    _fd = mkstemp(path.data());
+    if (_fd < 0) {
+        Log::e("Could not create spill file in %s!\n", directory.c_str());
+        exit(1);
+    }
+    // The file is only accessed through the open descriptor
+    unlink(path.data());
+    Log::v("Spilling past layers to %s\n", path.data());
+}
+
+SpillFile::~SpillFile() {
+    if (_map != nullptr) munmap(_map, _map_size);
+    if (_fd >= 0) close(_fd);
+}
+
+size_t SpillFile::append(const std::vector<uint8_t>& data) {
+    size_t offset = _size;
+    size_t written = 0;
+    while (written < data.size()) {
+        ssize_t result = pwrite(_fd, data.data()+written, data.size()-written, offset+written);
+        if (result < 0) {
+            Log::e("Could not write %lu bytes to spill file!\n", data.size());
+            exit(1);
+        }
+        written += result;
+    }
+    _size += data.size();
+    return offset;
+}
+
+const uint8_t* SpillFile::map(size_t offset, size_t length) {
+    if (offset+length > _map_size) {
+        // (Re-)map the entire file
+        if (_map != nullptr) munmap(_map, _map_size);
+        _map_size = _size;
+        void* map = mmap(nullptr, _map_size, PROT_READ, MAP_SHARED, _fd, 0);
+        if (map == MAP_FAILED) {
+            Log::e("Could not map spill file of size %lu!\n", _map_size);
+            exit(1);
+        }
+        _map = (uint8_t*) map;
+    }
+    return _map + offset;
+}
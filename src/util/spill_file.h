@@ -0,0 +1,59 @@
+
+#ifndef DOMPASCH_LILOTANE_SPILL_FILE_H
+#define DOMPASCH_LILOTANE_SPILL_FILE_H
+
+#include <vector>
+#include <algorithm>
+#include <string>
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+Append-only scratch file for data which is rarely read again.
+Data is written via append() and read back through a read-only memory mapping
+of the file, so that the OS can evict the pages whenever they are not needed.
+The file is unlinked right after creation and vanishes when the process exits.
+*/
+class SpillFile {
+
+private:
+    int _fd = -1;
+    size_t _size = 0;
+
+    uint8_t* _map = nullptr;
+    size_t _map_size = 0;
+
+public:
+    SpillFile(const std::string& directory);
+    ~SpillFile();
+
+    // Writes the data to the end of the file and returns the offset it was written to.
+    size_t append(const std::vector<uint8_t>& data);
+
+    // Returns a pointer to the data at [offset, offset+length) which stays valid
+    // until the next call to append() or map().
+    const uint8_t* map(size_t offset, size_t length);
+
+    size_t size() const {return _size;}
+};
+
+// Helpers for (de-)serializing plain vectors into a byte buffer
+template <typename T>
+void writeToBuffer(std::vector<uint8_t>& buf, const std::vector<T>& vec) {
+    uint64_t size = vec.size();
+    const uint8_t* sizePtr = (const uint8_t*) &size;
+    buf.insert(buf.end(), sizePtr, sizePtr+sizeof(uint64_t));
+    const uint8_t* dataPtr = (const uint8_t*) vec.data();
+    buf.insert(buf.end(), dataPtr, dataPtr+size*sizeof(T));
+}
+template <typename T>
+const uint8_t* readFromBuffer(const uint8_t* buf, std::vector<T>& vec) {
+    uint64_t size;
+    std::copy(buf, buf+sizeof(uint64_t), (uint8_t*) &size);
+    buf += sizeof(uint64_t);
+    vec.resize(size);
+    std::copy(buf, buf+size*sizeof(T), (uint8_t*) vec.data());
+    return buf + size*sizeof(T);
+}
+
+#endif